@@ -0,0 +1,68 @@
+#ifndef LATTICA_CACHE_H
+#define LATTICA_CACHE_H
+#include <lattica/generate.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Shares generated geometry between identical requests. Entries are keyed by
+ * the canonical content of the shape config (shape, winding, UV mapping,
+ * flags, divisions, sizes; allocator and task interface are ignored) together with
+ * the requested vertex and index format, so two configs that would generate
+ * the same output hit the same entry.
+ *
+ * Acquired geometry is immutable and stays valid until released. Entries no
+ * longer acquired are kept for reuse and evicted least recently used first
+ * once their total payload size exceeds the byte budget. A cache is not
+ * thread-safe. */
+typedef struct LtcGeometryCache LtcGeometryCache;
+
+typedef struct
+{
+    uint64_t m_hits;
+    uint64_t m_misses;
+    uint64_t m_evictions;
+    uint32_t m_numEntries;
+    size_t   m_numBytes;
+    /* payload bytes the current references would take on top of m_numBytes
+     * if every one held its own copy */
+    size_t   m_numSharedBytes;
+} LtcGeometryCacheStats;
+
+/* allocator may be NULL for the default allocator; it also provides the
+ * geometry payloads. */
+LtcError_t ltcGeometryCacheCreate(const LtcAllocator *allocator, size_t byteBudget, LtcGeometryCache **outCache);
+/* All geometry must have been released. */
+void ltcGeometryCacheDestroy(LtcGeometryCache *cache);
+
+/* Looks up or generates config in the given format (as for
+ * ltcContextGenerateGeometry: m_buffer of attribFormats is ignored, indexSize
+ * may be LTC_INDEX_SIZE_NONE) and takes a reference on it. */
+LtcError_t ltcGeometryCacheAcquire(LtcGeometryCache *cache, const LtcConfig *config,
+                                   const LtcVertexAttribBuffer *attribFormats, uint32_t numAttribs,
+                                   LtcIndexSize_t indexSize, const LtcGeometry **outGeometry);
+void ltcGeometryCacheRelease(LtcGeometryCache *cache, const LtcGeometry *geometry);
+
+/* Looks up or generates the index buffer of config alone and takes a
+ * reference on it, released with ltcGeometryCacheRelease. Index buffers only
+ * depend on the grids a shape is built from, so configs differing in
+ * dimensions, and shapes whose grids coincide (a plane and a torus, say),
+ * share one template; its m_numVertices is the vertex count the indices
+ * address. Instances then generate vertices only, without an index buffer,
+ * and draw with the shared indices. indexSize must not be
+ * LTC_INDEX_SIZE_NONE, and LTC_CONFIG_FLAG_OPTIMIZE_VERTEX_FETCH is rejected
+ * since vertices generated without indices are not renumbered. */
+LtcError_t ltcGeometryCacheAcquireIndices(LtcGeometryCache *cache, const LtcConfig *config, LtcIndexSize_t indexSize,
+                                          const LtcGeometry **outGeometry);
+
+/* Drops every entry that is not acquired. */
+void ltcGeometryCacheTrim(LtcGeometryCache *cache);
+void ltcGeometryCacheGetStats(const LtcGeometryCache *cache, LtcGeometryCacheStats *outStats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LATTICA_CACHE_H */
@@ -0,0 +1,39 @@
+#ifndef LATTICA_CONTEXT_H
+#define LATTICA_CONTEXT_H
+#include <lattica/generate.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Arena that owns everything generated through it. Memory is taken from the
+ * parent allocator in chunks of at least m_chunkSize bytes and handed back in
+ * one go by ltcContextReset (chunks are kept for reuse) or ltcContextDestroy. */
+typedef struct LtcContext LtcContext;
+
+#define LTC_CONTEXT_ALIGNMENT 16
+
+/* parentAllocator may be NULL for the default allocator; chunkSize of 0
+ * selects a 1 MiB default. */
+LtcError_t ltcContextCreate(const LtcAllocator *parentAllocator, size_t chunkSize, LtcContext **outContext);
+void ltcContextDestroy(LtcContext *context);
+void ltcContextReset(LtcContext *context);
+
+/* Allocator view of the arena, usable as LtcConfig::m_allocator. Frees are
+ * no-ops; memory comes back on reset. */
+const LtcAllocator *ltcContextGetAllocator(LtcContext *context);
+
+/* Generates config into arena memory. attribFormats lists the wanted
+ * attributes (their m_buffer is ignored); indexSize may be
+ * LTC_INDEX_SIZE_NONE to skip indices. The index buffer and all payloads of
+ * outGeometry live in the arena until the next reset. */
+LtcError_t ltcContextGenerateGeometry(LtcContext *context, const LtcConfig *config,
+                                      const LtcVertexAttribBuffer *attribFormats, uint32_t numAttribs,
+                                      LtcIndexSize_t indexSize, LtcGeometry *outGeometry);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LATTICA_CONTEXT_H */
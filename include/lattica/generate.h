@@ -1,5 +1,6 @@
 #ifndef LATTICA_GENERATE_H
 #define LATTICA_GENERATE_H
+#include <stddef.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -12,9 +13,39 @@ typedef enum
     LTC_OK = 0,
     LTC_ERR_INVALIDARGS,
     LTC_ERR_NOSUPPORT,
-    LTC_ERR_INTERNAL
+    LTC_ERR_INTERNAL,
+    LTC_ERR_OUTOFMEMORY
 } LtcError_t;
 
+/* Memory callbacks used for every allocation lattica makes. All three
+ * functions must be set; ltcInitDefaultAllocator routes them to malloc. */
+typedef struct
+{
+    void *(*m_alloc)(size_t size, void *userData);
+    void *(*m_realloc)(void *ptr, size_t size, void *userData);
+    void  (*m_free)(void *ptr, void *userData);
+    void   *m_userData;
+} LtcAllocator;
+
+void ltcInitDefaultAllocator(LtcAllocator *allocator);
+
+typedef void (*LtcTaskFn)(void *taskData, uint32_t task);
+
+/* Hooks into an external job system. Generation splits its work into tasks
+ * that each write their own disjoint part of the output, so the tasks of one
+ * m_enqueue call may run in any order and all at once. */
+typedef struct
+{
+    /* Schedules fn(taskData, t) for every t in [0, numTasks). The return
+     * value is passed to m_wait as is and may be NULL. */
+    void *(*m_enqueue)(LtcTaskFn fn, void *taskData, uint32_t numTasks, void *userData);
+    /* Returns once every task of handle has finished. */
+    void  (*m_wait)(void *handle, void *userData);
+    /* How many tasks can run at the same time; below 2 nothing is split. */
+    uint32_t m_numWorkers;
+    void    *m_userData;
+} LtcTaskInterface;
+
 typedef enum
 {
     LTC_SHAPE_NONE = 0,
@@ -39,6 +70,10 @@ typedef enum
     LTC_VERTEX_ATTRIB_TYPE_TEXCOORD  = 0x4,
     LTC_VERTEX_ATTRIB_TYPE_TANGENT   = 0x8,
     LTC_VERTEX_ATTRIB_TYPE_BITANGENT = 0x10,
+    /* tangent frame as one FLOAT4 quaternion rotating x, y, z onto tangent,
+     * bitangent and normal; w is kept at least 1 / 32767 away from zero and
+     * its sign is the tangent handedness. FLOAT, HALF or SNORM16 */
+    LTC_VERTEX_ATTRIB_TYPE_QTANGENT  = 0x20,
 } LtcVertexAttribType_t;
 
 typedef enum
@@ -50,12 +85,43 @@ typedef enum
     LTC_VERTEX_ATTRIB_SIZE_FLOAT4,
 } LtcVertexAttribSize_t;
 
+/* How each component is stored; LtcVertexAttribSize_t still gives the number
+ * of components. Values outside a normalised range are clamped. Worst case
+ * round-trip errors:
+ *   HALF      IEEE binary16, round to nearest even: relative 2^-11 within
+ *             [2^-14, 65504], absolute 2^-25 below that
+ *   SNORM16   [-1, 1] as round(x * 32767): absolute 1 / 65534
+ *   UNORM16   [0, 1] as round(x * 65535): absolute 1 / 131070
+ *   SNORM_10_10_10_2
+ *             x, y, z as 10 bit snorm (round(x * 511)) in bits 0-29 from
+ *             the low end, w as 2 bit snorm in bits 30-31: absolute 1 / 1022
+ *             for x, y, z and exact for w in {-1, 0, 1}; one 32 bit word per
+ *             vertex, FLOAT3 or FLOAT4 only (w is 0 for FLOAT3)
+ *   OCT_SNORM16, OCT_SNORM8
+ *             unit vector folded onto the octahedron and stored as two snorm
+ *             values, x in the low half of one 32 or 16 bit word; FLOAT3
+ *             NORMAL, TANGENT or BITANGENT only. Decoded directions are
+ *             within 0.004 (16 bit) and 1 (8 bit) degrees */
+typedef enum
+{
+    LTC_VERTEX_ATTRIB_FORMAT_FLOAT = 0,
+    LTC_VERTEX_ATTRIB_FORMAT_HALF,
+    LTC_VERTEX_ATTRIB_FORMAT_SNORM16,
+    LTC_VERTEX_ATTRIB_FORMAT_UNORM16,
+    LTC_VERTEX_ATTRIB_FORMAT_SNORM_10_10_10_2,
+    LTC_VERTEX_ATTRIB_FORMAT_OCT_SNORM16,
+    LTC_VERTEX_ATTRIB_FORMAT_OCT_SNORM8,
+} LtcVertexAttribFormat_t;
+
 typedef enum
 {
     LTC_INDEX_SIZE_NONE = 0,
     LTC_INDEX_SIZE_8    = 1,
     LTC_INDEX_SIZE_16   = 2,
     LTC_INDEX_SIZE_32   = 4,
+    /* resolved on every generation to the smallest size that addresses all
+     * vertices; the size used is reported in LtcGeometry::m_indexSize */
+    LTC_INDEX_SIZE_AUTO = 0xFF,
 } LtcIndexSize_t;
 
 typedef enum 
@@ -69,14 +135,32 @@ typedef enum
     LTC_WINDING_ORDER_CLOCKWISE,
 } LtcWindingOrder_t;
 
-typedef struct LtcVertexAttribBuffer
+typedef enum
 {
-    void                 *m_buffer;
-    uint32_t              m_stride;
-    LtcVertexAttribType_t m_attribType;
-    LtcVertexAttribSize_t m_attribSize;
-
-    struct LtcVertexAttribBuffer *next;
+    LTC_INDEX_TOPOLOGY_TRIANGLE_LIST = 0,
+    /* one strip per quad row, each followed by the primitive restart index
+     * (ltcGetPrimitiveRestartIndex); rows keep the list's diagonals, and rows
+     * collapsing to a pole keep their zero area triangles. About a third of
+     * the list's indices on wide grids, more on rows a quad or two wide */
+    LTC_INDEX_TOPOLOGY_TRIANGLE_STRIP,
+} LtcIndexTopology_t;
+
+/* Number of LtcVertexAttribType_t bits; slot i of the attribute table holds
+ * the attribute with type bit (1 << i). */
+#define LTC_VERTEX_ATTRIB_COUNT 6
+
+/* Vertex v, component c is written m_stride * v + m_componentStride * c
+ * bytes into m_buffer. A stride of 0 means tightly packed; a component stride
+ * of 0 keeps the components of one vertex adjacent. A packed format counts as
+ * a single component. */
+typedef struct
+{
+    void                   *m_buffer;
+    uint32_t                m_stride;
+    LtcVertexAttribType_t   m_attribType;
+    LtcVertexAttribSize_t   m_attribSize;
+    uint32_t                m_componentStride;
+    LtcVertexAttribFormat_t m_format;
 } LtcVertexAttribBuffer;
 
 typedef struct
@@ -85,23 +169,120 @@ typedef struct
     LtcIndexSize_t  m_indexSize;
 } LtcIndexBuffer;
 
+/* Bit of LtcGeometry::m_allocatedBuffers for the index payload; attribute
+ * payloads use their LtcVertexAttribType_t bit. */
+#define LTC_ALLOCATED_INDEX_BUFFER 0x80000000u
+
+#define LTC_TOPOLOGY_WORDS 4
+
 typedef struct
 {
-    LtcVertexAttribBuffer *m_vertexAttribs;
+    LtcVertexAttribBuffer  m_vertexAttribs[LTC_VERTEX_ATTRIB_COUNT];
+    uint32_t               m_vertexAttribMask;
     uint32_t               m_numVertices;
     LtcIndexBuffer        *m_indices;
     uint32_t               m_numIndices;
+    /* size the indices were written with; differs from m_indices->m_indexSize
+     * only when that is LTC_INDEX_SIZE_AUTO */
+    LtcIndexSize_t         m_indexSize;
+
+    /* payloads lattica allocated because they were attached as NULL */
+    LtcAllocator           m_allocator;
+    uint32_t               m_allocatedBuffers;
+
+    /* shape, settings and division counts of the last ltcGenerateGeometry
+     * call, for ltcUpdateGeometry; zeroed when the buffers are changed or
+     * written any other way */
+    uint32_t               m_topology[LTC_TOPOLOGY_WORDS];
 } LtcGeometry;
 
-LtcError_t ltcAddVertexAttribBuffer(LtcGeometry *geometry, LtcVertexAttribBuffer *attribBuffer);
-LtcError_t ltcRemoveVertexAttribBuffer(LtcVertexAttribType_t attribType);
+/* Copies attribBuffer into the slot for its type and enables it. The table
+ * entry is authoritative afterwards, e.g. for payloads lattica allocates.
+ *
+ * API break: attributes used to form a caller-owned linked list threaded
+ * through a next field, and ltcAddVertexAttribBuffer linked the caller's node
+ * in place. Both the next field and the list are gone. Changes made to
+ * attribBuffer after the call are not seen; edit ltcGetVertexAttribBuffer's
+ * entry instead. Walk the attributes by testing m_vertexAttribMask bits
+ * rather than following next pointers. The old
+ * ltcRemoveVertexAttribBuffer(attribType) had no geometry to act on and was
+ * never implemented, so it now takes the geometry. */
+LtcError_t ltcAddVertexAttribBuffer(LtcGeometry *geometry, const LtcVertexAttribBuffer *attribBuffer);
+LtcError_t ltcRemoveVertexAttribBuffer(LtcGeometry *geometry, LtcVertexAttribType_t attribType);
+/* NULL if the attribute is not enabled */
+LtcVertexAttribBuffer *ltcGetVertexAttribBuffer(LtcGeometry *geometry, LtcVertexAttribType_t attribType);
 LtcError_t ltcSetIndexBuffer(LtcGeometry *geometry, LtcIndexBuffer *indexBuffer);
 
+/* Interleaved vertex format: every element lives in one buffer at m_offset
+ * bytes into each m_stride sized vertex. */
+typedef struct
+{
+    LtcVertexAttribType_t   m_attribType;
+    LtcVertexAttribSize_t   m_attribSize;
+    uint32_t                m_offset;
+    LtcVertexAttribFormat_t m_format;
+} LtcVertexElement;
+
+typedef struct
+{
+    LtcVertexElement m_elements[LTC_VERTEX_ATTRIB_COUNT];
+    uint32_t         m_numElements;
+    uint32_t         m_stride;
+} LtcVertexLayout;
+
+void ltcInitVertexLayout(LtcVertexLayout *layout);
+/* Appends an element after the existing ones, aligned to its component size,
+ * and grows the stride to keep every element aligned; m_offset and m_stride
+ * may also be set by hand for padded formats. ltcAddVertexElement stores
+ * floats. */
+LtcError_t ltcAddVertexElement(LtcVertexLayout *layout, LtcVertexAttribType_t attribType, LtcVertexAttribSize_t attribSize);
+LtcError_t ltcAddVertexElementFormat(LtcVertexLayout *layout, LtcVertexAttribType_t attribType,
+                                     LtcVertexAttribSize_t attribSize, LtcVertexAttribFormat_t format);
+size_t ltcGetVertexLayoutBufferSize(const LtcVertexLayout *layout, uint32_t numVertices);
+/* Points the attribute table entries of every element into buffer, replacing
+ * attributes of the same type. buffer must hold
+ * ltcGetVertexLayoutBufferSize bytes and is never owned by lattica. */
+LtcError_t ltcSetVertexLayout(LtcGeometry *geometry, const LtcVertexLayout *layout, void *buffer);
+
+/* Structure-of-arrays format: every component of every element in layout
+ * gets its own stream (x[], y[], z[], ...) starting on an alignment boundary
+ * and padded to a multiple of alignment bytes, i.e. to the SIMD width.
+ * Element offsets and the layout stride are ignored. Padding lanes repeat the
+ * last vertex. buffer must be aligned to alignment, a power of two >= 4.
+ * ltcGetVertexStreamSize is the size of one float stream; 16 bit formats
+ * pack two lanes per float and a packed format uses a single stream. */
+size_t ltcGetVertexStreamSize(uint32_t numVertices, uint32_t alignment);
+size_t ltcGetVertexStreamsBufferSize(const LtcVertexLayout *layout, uint32_t numVertices, uint32_t alignment);
+LtcError_t ltcSetVertexStreams(LtcGeometry *geometry, const LtcVertexLayout *layout, uint32_t numVertices,
+                               uint32_t alignment, void *buffer);
+
+/* Frees the payloads listed in m_allocatedBuffers and resets them to NULL.
+ * Caller-provided payloads are left untouched. */
+void ltcFreeGeometry(LtcGeometry *geometry);
+
+typedef enum
+{
+    LTC_CONFIG_FLAG_NONE                  = 0x0,
+    /* reorders triangles for the post-transform vertex cache once indices are
+     * written, see ltcOptimizeVertexCache in lattica/optimize.h */
+    LTC_CONFIG_FLAG_OPTIMIZE_VERTEX_CACHE = 0x1,
+    /* then renumbers vertices in first-use order, see ltcOptimizeVertexFetch */
+    LTC_CONFIG_FLAG_OPTIMIZE_VERTEX_FETCH = 0x2,
+} LtcConfigFlags_t;
+
 typedef struct
 {
-    LtcShape_t        m_shape;
-    LtcWindingOrder_t m_windingOrder;
-    LtcUvMapping_t    m_uvMapping;
+    LtcShape_t         m_shape;
+    LtcWindingOrder_t  m_windingOrder;
+    LtcIndexTopology_t m_indexTopology;
+    LtcUvMapping_t     m_uvMapping;
+    /* the optimisation flags only apply to triangle lists */
+    uint32_t           m_flags;
+
+    /* NULL selects the default malloc based allocator */
+    const LtcAllocator *m_allocator;
+    /* NULL generates on the calling thread */
+    const LtcTaskInterface *m_taskInterface;
 } LtcConfig;
 
 void ltcInitDefaultConfig(LtcConfig *config);
@@ -208,8 +389,111 @@ typedef struct
 
 void ltcInitDefaultConfigTorusKnot(LtcConfigTorusKnot *config);
 
+typedef struct
+{
+    uint32_t m_numVertices;
+    uint32_t m_numIndices;
+} LtcGeometrySize;
+
+/* Exact element counts ltcGenerateGeometry will produce for config. Computed
+ * from the division counts alone, so buffers can be sized before generating. */
+LtcError_t ltcQueryGeometrySize(const LtcConfig *config, LtcGeometrySize *outSize);
+
+typedef struct
+{
+    float m_min[3];
+    float m_max[3];
+    float m_center[3];
+    float m_radius;
+} LtcBounds;
+
+/* Axis aligned box and bounding sphere of the shape config describes, worked
+ * out from its dimensions without generating anything. Both enclose every
+ * position ltcGenerateGeometry writes for any division counts. The box is
+ * exact and the sphere the smallest one for every shape but the torus knot,
+ * which is bounded by the torus its centre line winds around. Both are grown
+ * by 2^-20 of the radius to cover float rounding. */
+LtcError_t ltcQueryGeometryBounds(const LtcConfig *config, LtcBounds *outBounds);
+
+/* Byte sizes of caller-provided buffers holding the given element counts.
+ * LTC_INDEX_SIZE_AUTO is sized for 32 bit indices. */
+size_t ltcGetVertexAttribBufferSize(const LtcVertexAttribBuffer *attribBuffer, uint32_t numVertices);
+size_t ltcGetIndexBufferSize(LtcIndexSize_t indexSize, uint32_t numIndices);
+
+/* Smallest index size addressing numVertices vertices, as picked for
+ * LTC_INDEX_SIZE_AUTO. Strips reserve the largest index value for the restart
+ * index, so they are picked for numVertices + 1. */
+LtcIndexSize_t ltcGetIndexSizeForVertices(uint32_t numVertices);
+
+/* The largest value of indexSize, which strips use to restart. */
+uint32_t ltcGetPrimitiveRestartIndex(LtcIndexSize_t indexSize);
+
+/* Writes into the buffers attached to outGeometry, which must be large enough
+ * for the sizes reported by ltcQueryGeometrySize. Attached buffers whose
+ * m_buffer is NULL are allocated from the config's allocator instead, and
+ * resized on later calls until released with ltcFreeGeometry. */
 LtcError_t ltcGenerateGeometry(const LtcConfig *config, LtcGeometry *outGeometry);
 
+/* Regenerates geometry, last written by ltcGenerateGeometry, for config. When
+ * only dimensions changed since, i.e. shape, division counts, winding, index
+ * topology and flags are the same, the indices and texture coordinates are
+ * kept and the other attributes rewritten in place: positions only, plus the
+ * tangent frame for the cone, prism, pyramid and torus knot whose normals
+ * follow their proportions. Anything else falls back to
+ * ltcGenerateGeometry, as does LTC_CONFIG_FLAG_OPTIMIZE_VERTEX_FETCH since
+ * its vertex order is not kept. */
+LtcError_t ltcUpdateGeometry(const LtcConfig *config, LtcGeometry *geometry);
+
+/* Draw range of one submesh; its index values are relative to m_baseVertex. */
+typedef struct
+{
+    uint32_t m_baseVertex;
+    uint32_t m_numVertices;
+    uint32_t m_firstIndex;
+    uint32_t m_numIndices;
+} LtcSubmesh;
+
+/* Sizes for generating config as submeshes that each fit indexSize. Patches
+ * are cut between grid rows and the row on a cut is stored in both
+ * submeshes, so the vertex count can exceed ltcQueryGeometrySize.
+ * LTC_INDEX_SIZE_AUTO picks the smallest size up to 16 bit that keeps the
+ * mesh whole, or 16 bit when it has to be split. */
+LtcError_t ltcQueryGeometrySubmeshes(const LtcConfig *config, LtcIndexSize_t indexSize,
+                                     uint32_t *outNumSubmeshes, LtcGeometrySize *outSize);
+
+/* Like ltcGenerateGeometry, split by the index size of outGeometry's index
+ * buffer (which must be attached). outSubmeshes receives as many entries as
+ * ltcQueryGeometrySubmeshes reports. */
+LtcError_t ltcGenerateGeometrySubmeshes(const LtcConfig *config, LtcSubmesh *outSubmeshes, LtcGeometry *outGeometry);
+
+typedef enum
+{
+    LTC_BATCH_FLAG_NONE          = 0x0,
+    /* every item's indices start at 0; draw with m_firstVertex as base vertex */
+    LTC_BATCH_FLAG_LOCAL_INDICES = 0x1,
+} LtcBatchFlags_t;
+
+/* Where one config of a batch landed in the shared buffers. */
+typedef struct
+{
+    uint32_t m_firstVertex;
+    uint32_t m_numVertices;
+    uint32_t m_firstIndex;
+    uint32_t m_numIndices;
+} LtcBatchItem;
+
+LtcError_t ltcQueryGeometryBatchSize(const LtcConfig *const *configs, uint32_t count, LtcGeometrySize *outSize);
+
+/* Generates count configs back to back into the buffers of outGeometry, which
+ * follow the same rules as for ltcGenerateGeometry with the summed sizes.
+ * Items are packed grouped by shape; outItems[i] gives the ranges of
+ * configs[i]. All configs are validated before anything is written. They
+ * must all resolve to the same allocator (equal callbacks and user data, a
+ * NULL m_allocator meaning the default) and the same m_taskInterface pointer,
+ * or LTC_ERR_INVALIDARGS is returned. */
+LtcError_t ltcGenerateGeometryBatch(const LtcConfig *const *configs, uint32_t count, uint32_t flags,
+                                    LtcBatchItem *outItems, LtcGeometry *outGeometry);
+
 #ifdef __cplusplus
 }
 #endif
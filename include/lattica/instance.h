@@ -0,0 +1,41 @@
+#ifndef LATTICA_INSTANCE_H
+#define LATTICA_INSTANCE_H
+#include <lattica/generate.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Row-major 3x4 affine matrix taking unit mesh positions onto an instance:
+ * p' = m_matrix * (p, 1). Normals go through the inverse transpose of the 3x3
+ * part and tangents through the 3x3 part, both renormalised; the tangent w
+ * and so the bitangent sign are unchanged. */
+typedef struct
+{
+    float m_matrix[3][4];
+} LtcInstanceTransform;
+
+/* Rewrites config in place into the unit shape of its kind and returns the
+ * transform that maps the unit mesh back onto config, so instances of any
+ * size can share one mesh and one instanced draw:
+ *   plane, cuboid                        sizes 1, scaled per axis
+ *   sphere                               radius 1, uniform scale
+ *   cylinder, cone, prism, pyramid       radius and length 1, scaled in the
+ *                                        XZ plane and along Y
+ *   tube                                 outer radius and length 1
+ *   capsule, torus, torus knot           (major) radius 1, uniform scale
+ * Rounded ends and rings do not survive a non-uniform scale, so the tube,
+ * capsule, torus and torus knot keep their proportions in the unit config and
+ * only instances with equal proportions share a mesh. Division counts and the
+ * common settings are left alone; acquiring the unit configs from an
+ * LtcGeometryCache then yields one mesh per topology. Generating the unit
+ * config and applying the transform matches generating config up to float
+ * rounding. */
+LtcError_t ltcSplitInstanceTransform(LtcConfig *config, LtcInstanceTransform *outTransform);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LATTICA_INSTANCE_H */
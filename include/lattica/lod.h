@@ -0,0 +1,54 @@
+#ifndef LATTICA_LOD_H
+#define LATTICA_LOD_H
+#include <lattica/generate.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define LTC_MAX_LODS 8
+
+/* Largest distance between the triangles generated for config and the exact
+ * shape, from the chord error of its curved directions: 0 for the flat
+ * shapes, an upper bound for the others (a close estimate for the torus
+ * knot). */
+LtcError_t ltcQueryGeometryError(const LtcConfig *config, float *outError);
+
+/* Sets the division counts of config's curved directions to the smallest
+ * ones whose ltcQueryGeometryError stays within maxErrorPixels when the
+ * bounding sphere of ltcQueryGeometryBounds covers sizePixels on screen
+ * (2 * radius * focal length / distance, both in pixels). The tolerance is
+ * split evenly over the curved directions, which about minimises the
+ * triangle count. Flat directions have no chord error and keep their counts;
+ * counts are clamped to what the shape accepts and to 65535. */
+LtcError_t ltcSelectDivisions(LtcConfig *config, float sizePixels, float maxErrorPixels);
+
+/* Ranges of one level in the shared buffers, as LtcBatchItem, and its
+ * ltcQueryGeometryError. */
+typedef struct
+{
+    uint32_t m_firstVertex;
+    uint32_t m_numVertices;
+    uint32_t m_firstIndex;
+    uint32_t m_numIndices;
+    float    m_error;
+} LtcLod;
+
+/* Level k of a chain is config with every division count scaled by
+ * reduction^k (0 < reduction <= 1), rounded and kept at the smallest value
+ * the shape accepts. Shape dimensions and facet counts are left alone.
+ * numLods is 1 to LTC_MAX_LODS. */
+LtcError_t ltcQueryLodChainSize(const LtcConfig *config, uint32_t numLods, float reduction, LtcGeometrySize *outSize);
+
+/* Generates every level back to back into outGeometry as
+ * ltcGenerateGeometryBatch does, level 0 first; flags are LtcBatchFlags_t.
+ * outLods receives numLods entries. */
+LtcError_t ltcGenerateLodChain(const LtcConfig *config, uint32_t numLods, float reduction, uint32_t flags,
+                               LtcLod *outLods, LtcGeometry *outGeometry);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LATTICA_LOD_H */
@@ -0,0 +1,77 @@
+#ifndef LATTICA_MESHLET_H
+#define LATTICA_MESHLET_H
+#include <lattica/generate.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Meshlets for mesh shader and cluster culling pipelines, cut straight from
+ * the quad grids the shapes are generated from: every meshlet is a tile of
+ * one patch, so no adjacency search or clustering is needed. */
+#define LTC_MESHLET_MAX_VERTICES  256
+#define LTC_MESHLET_MAX_TRIANGLES 512
+
+typedef struct
+{
+    uint32_t m_maxVertices;     /* 4 to LTC_MESHLET_MAX_VERTICES */
+    uint32_t m_maxTriangles;    /* 2 to LTC_MESHLET_MAX_TRIANGLES */
+} LtcMeshletLimits;
+
+/* 64 vertices and 124 triangles. */
+void ltcInitDefaultMeshletLimits(LtcMeshletLimits *limits);
+
+/* Vertices m_vertices[m_vertexOffset ...] index the geometry's vertex buffers;
+ * triangle t is the local vertex numbers m_triangles[m_triangleOffset + 3 * t
+ * ...], in the configured winding.
+ *
+ * Bounds are computed from the surface positions: a sphere around the
+ * vertices and a normal cone over the front faces. Every triangle faces away
+ * from a camera at position c when
+ *     dot(normalize(m_coneApex - c), m_coneAxis) >= m_coneCutoff
+ * or equivalently, without the apex,
+ *     dot(m_center - c, m_coneAxis) >= m_coneCutoff * length(m_center - c) + m_radius.
+ * A cutoff of 1 means the normals are too spread out to ever cull. */
+typedef struct
+{
+    uint32_t m_vertexOffset;
+    uint32_t m_triangleOffset;
+    uint32_t m_numVertices;
+    uint32_t m_numTriangles;
+
+    float    m_center[3];
+    float    m_radius;
+    float    m_coneApex[3];
+    float    m_coneAxis[3];
+    float    m_coneCutoff;
+} LtcMeshlet;
+
+typedef struct
+{
+    uint32_t m_numMeshlets;
+    uint32_t m_numVertices;     /* entries of m_vertices */
+    uint32_t m_numTriangles;    /* m_triangles holds 3 bytes for each */
+} LtcMeshletCounts;
+
+typedef struct
+{
+    LtcMeshlet *m_meshlets;
+    uint32_t   *m_vertices;
+    uint8_t    *m_triangles;
+} LtcMeshletBuffers;
+
+LtcError_t ltcQueryGeometryMeshlets(const LtcConfig *config, const LtcMeshletLimits *limits, LtcMeshletCounts *outCounts);
+
+/* Generates config into outGeometry as ltcGenerateGeometry does (an index
+ * buffer is optional) and fills the arrays of outMeshlets, sized as
+ * ltcQueryGeometryMeshlets reports. LTC_CONFIG_FLAG_OPTIMIZE_VERTEX_FETCH
+ * would renumber the vertices the meshlets refer to and is rejected. */
+LtcError_t ltcGenerateGeometryMeshlets(const LtcConfig *config, const LtcMeshletLimits *limits,
+                                       const LtcMeshletBuffers *outMeshlets, LtcGeometry *outGeometry);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LATTICA_MESHLET_H */
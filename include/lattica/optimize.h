@@ -0,0 +1,52 @@
+#ifndef LATTICA_OPTIMIZE_H
+#define LATTICA_OPTIMIZE_H
+#include <lattica/generate.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Size of the LRU cache the optimiser models; a good fit for FIFO caches of
+ * 16 to 32 entries. */
+#define LTC_VERTEX_CACHE_SIZE 32
+
+/* Post-transform cache behaviour of an index buffer. ACMR is transformed
+ * vertices per triangle (0.5 at best for a regular grid, 3 without reuse),
+ * ATVR is transformed vertices per referenced vertex (1 at best). */
+typedef struct
+{
+    uint32_t m_numTransformed;
+    float    m_acmr;
+    float    m_atvr;
+} LtcVertexCacheStats;
+
+/* Reorders the triangles of a triangle list in place so consecutive
+ * triangles share vertices, using Forsyth's linear-speed scoring. Each
+ * triangle keeps its vertex order and so its winding. Indices must be below
+ * numVertices. allocator may be NULL for the default allocator; scratch is
+ * about 10 bytes per index and 16 per vertex. */
+LtcError_t ltcOptimizeVertexCache(const LtcIndexBuffer *indices, uint32_t numIndices, uint32_t numVertices,
+                                  const LtcAllocator *allocator);
+
+/* Renumbers the vertices of geometry in the order the index buffer first uses
+ * them, moving the data of every attribute buffer to match and rewriting the
+ * indices, so vertex fetch reads the buffers front to back. Run it after
+ * ltcOptimizeVertexCache. Unreferenced vertices move to the end. The
+ * scratch comes from the geometry's allocator, or the default one when it
+ * has none.
+ *
+ * Generated grids are stored row by row, which already suits the rings that
+ * ltcOptimizeVertexCache walks on them; the remap mainly pays off for index
+ * orders that have no such structure, so measure before enabling it. */
+LtcError_t ltcOptimizeVertexFetch(LtcGeometry *geometry);
+
+/* Simulates a FIFO cache of cacheSize entries over the triangle list. */
+LtcError_t ltcAnalyzeVertexCache(const LtcIndexBuffer *indices, uint32_t numIndices, uint32_t numVertices,
+                                 uint32_t cacheSize, const LtcAllocator *allocator, LtcVertexCacheStats *outStats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LATTICA_OPTIMIZE_H */
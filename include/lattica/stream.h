@@ -0,0 +1,70 @@
+#ifndef LATTICA_STREAM_H
+#define LATTICA_STREAM_H
+#include <lattica/generate.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Generation of meshes too large to hold at once, such as a plane of
+ * 65535 x 65535 quads. The mesh is cut between grid rows into chunks of at
+ * most maxChunkVertices vertices, which are generated one after the other
+ * into the same buffers and handed to a callback, so memory stays bounded by
+ * one chunk. Counts over the whole stream are 64 bit.
+ *
+ * By default every chunk stands alone, as a submesh does: its index values
+ * start at 0, a grid row on a cut is stored in both chunks, and the
+ * optimisation flags apply per chunk. */
+typedef enum
+{
+    LTC_STREAM_FLAG_NONE           = 0x0,
+    /* index values are positions in the whole vertex stream instead. Chunks
+     * then share no vertices, the last quad row of a chunk refers to the
+     * first vertex row of the next one, and the whole stream has to fit the
+     * index size. Not with the optimisation flags */
+    LTC_STREAM_FLAG_GLOBAL_INDICES = 0x1,
+} LtcStreamFlags_t;
+
+typedef struct
+{
+    uint64_t m_chunk;
+    /* where the chunk goes in the whole vertex and index streams */
+    uint64_t m_firstVertex;
+    uint64_t m_firstIndex;
+    uint32_t m_numVertices;
+    uint32_t m_numIndices;
+} LtcStreamChunk;
+
+typedef struct
+{
+    uint64_t        m_numChunks;
+    uint64_t        m_numVertices;
+    uint64_t        m_numIndices;
+    /* largest vertex and index counts of any chunk, which the chunk buffers
+     * have to hold */
+    LtcGeometrySize m_maxChunkSize;
+} LtcStreamSize;
+
+/* Called once per chunk, in stream order, with the chunk in geometry. A
+ * result other than LTC_OK stops the stream and is returned. */
+typedef LtcError_t (*LtcStreamFn)(const LtcStreamChunk *chunk, const LtcGeometry *geometry, void *userData);
+
+/* flags are LtcStreamFlags_t. maxChunkVertices has to take two vertex rows of
+ * the widest patch (one with global indices). */
+LtcError_t ltcQueryGeometryStream(const LtcConfig *config, uint32_t maxChunkVertices, uint32_t flags,
+                                  LtcStreamSize *outSize);
+
+/* Generates config chunk by chunk into the buffers attached to
+ * chunkGeometry, which must hold m_maxChunkSize; payloads attached as NULL
+ * are allocated once from the config's allocator, as ltcGenerateGeometry
+ * does. Each chunk overwrites the previous one, and m_numVertices and
+ * m_numIndices of chunkGeometry are set for it before fn is called. */
+LtcError_t ltcGenerateGeometryStream(const LtcConfig *config, uint32_t maxChunkVertices, uint32_t flags,
+                                     LtcGeometry *chunkGeometry, LtcStreamFn fn, void *userData);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LATTICA_STREAM_H */
@@ -0,0 +1,33 @@
+#ifndef LATTICA_THREADPOOL_H
+#define LATTICA_THREADPOOL_H
+#include <lattica/generate.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Built-in LtcTaskInterface for callers without a job system of their own: a
+ * pool of pthreads where workers that run dry steal half of another worker's
+ * remaining tasks. Large meshes are split into ranges of grid rows and
+ * batches into runs of items; every vertex and index is computed exactly as
+ * on a single thread, so output is identical with or without the pool.
+ *
+ * The thread calling m_wait takes part in the work. Only one set of tasks is
+ * in flight at a time; enqueues from other threads block until it is done. */
+typedef struct LtcThreadPool LtcThreadPool;
+
+/* numThreads counts the calling thread; 0 selects one per online core.
+ * allocator may be NULL for the default allocator. */
+LtcError_t ltcThreadPoolCreate(const LtcAllocator *allocator, uint32_t numThreads, LtcThreadPool **outPool);
+void ltcThreadPoolDestroy(LtcThreadPool *pool);
+uint32_t ltcThreadPoolGetNumThreads(const LtcThreadPool *pool);
+
+/* Task interface view of the pool, usable as LtcConfig::m_taskInterface. */
+const LtcTaskInterface *ltcThreadPoolGetTaskInterface(LtcThreadPool *pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LATTICA_THREADPOOL_H */
@@ -0,0 +1,146 @@
+#include "internal.h"
+
+#define LTC_NUM_SHAPES (LTC_SHAPE_TORUSKNOT + 1)
+
+LtcError_t ltcQueryGeometryBatchSize(const LtcConfig *const *configs, uint32_t count, LtcGeometrySize *outSize)
+{
+    if(!configs || !outSize)
+        return LTC_ERR_INVALIDARGS;
+
+    uint64_t numVertices = 0;
+    uint64_t numIndices  = 0;
+    for(uint32_t c = 0; c < count; ++c)
+    {
+        LtcGeometrySize size;
+        LtcError_t err = configs[c] ? ltcQueryGeometrySize(configs[c], &size) : LTC_ERR_INVALIDARGS;
+        if(err != LTC_OK)
+            return err;
+        numVertices += size.m_numVertices;
+        numIndices  += size.m_numIndices;
+    }
+
+    if(numVertices > UINT32_MAX || numIndices > UINT32_MAX)
+        return LTC_ERR_INVALIDARGS;
+
+    outSize->m_numVertices = (uint32_t)numVertices;
+    outSize->m_numIndices  = (uint32_t)numIndices;
+    return LTC_OK;
+}
+
+/* A batch allocates through one allocator and schedules through one task
+ * interface, so every config must resolve to the same ones as the first. */
+static int ltcSharesResources(const LtcConfig *config, const LtcConfig *first)
+{
+    const LtcAllocator *allocator = ltcGetAllocator(config);
+    const LtcAllocator *firstAllocator = ltcGetAllocator(first);
+    return allocator->m_alloc == firstAllocator->m_alloc && allocator->m_realloc == firstAllocator->m_realloc &&
+           allocator->m_free == firstAllocator->m_free && allocator->m_userData == firstAllocator->m_userData &&
+           config->m_taskInterface == first->m_taskInterface;
+}
+
+LtcError_t ltcGenerateGeometryBatch(const LtcConfig *const *configs, uint32_t count, uint32_t flags,
+                                    LtcBatchItem *outItems, LtcGeometry *outGeometry)
+{
+    if(!configs || !count || !outItems || !outGeometry || !configs[0])
+        return LTC_ERR_INVALIDARGS;
+
+    const LtcAllocator *allocator = ltcGetAllocator(configs[0]);
+    if(ltcValidateAllocator(allocator) != LTC_OK)
+        return LTC_ERR_INVALIDARGS;
+
+    LtcLayout *layouts = (LtcLayout *)allocator->m_alloc((size_t)count * (sizeof(LtcLayout) + sizeof(LtcEmitItem) + sizeof(uint32_t)),
+                                                         allocator->m_userData);
+    if(!layouts)
+        return LTC_ERR_OUTOFMEMORY;
+    LtcEmitItem *emitItems = (LtcEmitItem *)(layouts + count);
+    uint32_t *order = (uint32_t *)(emitItems + count);
+
+    /* validate and size everything up front, bucketing items by shape so the
+     * emit pass runs each shape's generator back to back */
+    uint32_t bucketStart[LTC_NUM_SHAPES + 1] = { 0 };
+    LtcError_t err = LTC_OK;
+    for(uint32_t c = 0; c < count && err == LTC_OK; ++c)
+    {
+        err = configs[c] ? ltcBuildLayout(configs[c], &layouts[c]) : LTC_ERR_INVALIDARGS;
+        if(err == LTC_OK && !ltcSharesResources(configs[c], configs[0]))
+            err = LTC_ERR_INVALIDARGS;
+        if(err == LTC_OK)
+            ++bucketStart[configs[c]->m_shape + 1];
+    }
+    for(uint32_t b = 0; b < LTC_NUM_SHAPES; ++b)
+        bucketStart[b + 1] += bucketStart[b];
+    for(uint32_t c = 0; c < count && err == LTC_OK; ++c)
+        order[bucketStart[configs[c]->m_shape]++] = c;
+
+    uint64_t numVertices = 0;
+    uint64_t numIndices  = 0;
+    uint32_t maxItemVertices = 0;
+    LtcIndexTopology_t topology = LTC_INDEX_TOPOLOGY_TRIANGLE_LIST;
+    for(uint32_t o = 0; o < count && err == LTC_OK; ++o)
+    {
+        uint32_t c = order[o];
+        LtcGeometrySize size;
+        err = ltcLayoutSize(&layouts[c], &size);
+        if(err != LTC_OK)
+            break;
+
+        outItems[c].m_firstVertex = (uint32_t)numVertices;
+        outItems[c].m_numVertices = size.m_numVertices;
+        outItems[c].m_firstIndex  = (uint32_t)numIndices;
+        outItems[c].m_numIndices  = outGeometry->m_indices ? size.m_numIndices : 0;
+        numVertices += size.m_numVertices;
+        numIndices  += size.m_numIndices;
+        if(numVertices > UINT32_MAX || numIndices > UINT32_MAX)
+            err = LTC_ERR_INVALIDARGS;
+        if(size.m_numVertices > maxItemVertices)
+            maxItemVertices = size.m_numVertices;
+        if(configs[c]->m_indexTopology == LTC_INDEX_TOPOLOGY_TRIANGLE_STRIP)
+            topology = LTC_INDEX_TOPOLOGY_TRIANGLE_STRIP;
+    }
+
+    int localIndices = (flags & LTC_BATCH_FLAG_LOCAL_INDICES) != 0;
+    for(uint32_t o = 0; o < count && err == LTC_OK; ++o)
+    {
+        const LtcBatchItem *item = &outItems[order[o]];
+        emitItems[o].m_layout      = &layouts[order[o]];
+        emitItems[o].m_firstVertex = item->m_firstVertex;
+        emitItems[o].m_firstIndex  = item->m_firstIndex;
+        emitItems[o].m_indexBase   = localIndices ? item->m_firstVertex : 0;
+    }
+
+    LtcGeometrySize total = { (uint32_t)numVertices, (uint32_t)numIndices };
+    uint32_t indexRange = ltcIndexRange(topology, localIndices ? maxItemVertices : total.m_numVertices);
+    if(err == LTC_OK)
+        err = ltcValidateBuffers(outGeometry, indexRange);
+    if(err == LTC_OK)
+    {
+        ltcResolveIndexSize(outGeometry, indexRange);
+        err = ltcAllocateBuffers(allocator, outGeometry, &total);
+    }
+
+    if(err == LTC_OK)
+    {
+        LtcVertexWriter writer;
+        LtcIndexBuffer indices;
+        ltcInitVertexWriter(outGeometry, &writer);
+        err = ltcEmitItems(emitItems, count, total.m_numVertices, allocator, configs[0]->m_taskInterface,
+                           &writer, ltcGetWrittenIndices(outGeometry, &indices));
+
+        for(uint32_t c = 0; c < count && err == LTC_OK && outGeometry->m_indices; ++c)
+        {
+            const LtcBatchItem *item = &outItems[c];
+            err = ltcOptimizeRange(allocator, configs[c]->m_flags, &writer, &indices, item->m_firstIndex, item->m_numIndices,
+                                   localIndices ? 0 : item->m_firstVertex, item->m_firstVertex, item->m_numVertices);
+        }
+
+        if(err == LTC_OK)
+        {
+            ltcPadVertexStreams(&writer, total.m_numVertices);
+            outGeometry->m_numVertices = total.m_numVertices;
+            outGeometry->m_numIndices  = outGeometry->m_indices ? total.m_numIndices : 0;
+        }
+    }
+
+    allocator->m_free(layouts, allocator->m_userData);
+    return err;
+}
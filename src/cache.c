@@ -0,0 +1,583 @@
+#include <lattica/cache.h>
+#include "internal.h"
+#include <string.h>
+
+#define LTC_CACHE_MIN_BUCKETS 64
+/* shape, winding, index topology, UV mapping, flags, up to 8 shape fields,
+ * attribute formats, index size */
+#define LTC_CACHE_CONFIG_KEY (5 + 8 + LTC_VERTEX_ATTRIB_COUNT + 1)
+/* LTC_SHAPE_NONE, index topology, flags, index size, patch count, three words
+ * per patch */
+#define LTC_CACHE_TEMPLATE_KEY (5 + 3 * LTC_MAX_PATCHES)
+#define LTC_CACHE_MAX_KEY (LTC_CACHE_CONFIG_KEY > LTC_CACHE_TEMPLATE_KEY ? LTC_CACHE_CONFIG_KEY : LTC_CACHE_TEMPLATE_KEY)
+#define LTC_CACHE_PAYLOAD_ALIGNMENT 16
+
+typedef struct
+{
+    uint32_t m_words[LTC_CACHE_MAX_KEY];
+    uint32_t m_size;
+} LtcCacheKey;
+
+/* An entry and its payloads live in one allocation. m_geometry comes first so
+ * the pointers handed out convert straight back to the entry. */
+typedef struct LtcCacheEntry
+{
+    LtcGeometry           m_geometry;
+    LtcIndexBuffer        m_indices;
+    struct LtcCacheEntry *m_nextInBucket;
+    struct LtcCacheEntry *m_prevUsed;
+    struct LtcCacheEntry *m_nextUsed;
+    LtcCacheKey           m_key;
+    uint64_t              m_hash;
+    size_t                m_numBytes;
+    uint32_t              m_refCount;
+} LtcCacheEntry;
+
+struct LtcGeometryCache
+{
+    LtcAllocator           m_allocator;
+    LtcCacheEntry        **m_buckets;
+    uint32_t               m_numBuckets;
+    /* most recently acquired first */
+    LtcCacheEntry         *m_mostRecent;
+    LtcCacheEntry         *m_leastRecent;
+    size_t                 m_byteBudget;
+    LtcGeometryCacheStats  m_stats;
+};
+
+static void ltcKeyPush(LtcCacheKey *key, uint32_t word)
+{
+    key->m_words[key->m_size++] = word;
+}
+
+/* -0 and +0 generate the same geometry, so they share a key. */
+static void ltcKeyPushFloat(LtcCacheKey *key, float value)
+{
+    uint32_t bits = 0;
+    if(value != 0.0f)
+        memcpy(&bits, &value, sizeof(bits));
+    ltcKeyPush(key, bits);
+}
+
+/* Fields in declaration order; anything that does not change the output
+ * (allocator, task interface, padding) is left out. */
+static void ltcKeyPushConfig(LtcCacheKey *key, const LtcConfig *config)
+{
+    ltcKeyPush(key, (uint32_t)config->m_shape);
+    ltcKeyPush(key, (uint32_t)config->m_windingOrder);
+    ltcKeyPush(key, (uint32_t)config->m_indexTopology);
+    ltcKeyPush(key, (uint32_t)config->m_uvMapping);
+    ltcKeyPush(key, config->m_flags);
+
+    switch(config->m_shape)
+    {
+    case LTC_SHAPE_PLANE:
+    {
+        const LtcConfigPlane *plane = (const LtcConfigPlane *)config;
+        ltcKeyPush(key, plane->m_divX);
+        ltcKeyPush(key, plane->m_divY);
+        ltcKeyPushFloat(key, plane->m_sizeX);
+        ltcKeyPushFloat(key, plane->m_sizeY);
+        break;
+    }
+    case LTC_SHAPE_CUBOID:
+    {
+        const LtcConfigCuboid *cuboid = (const LtcConfigCuboid *)config;
+        ltcKeyPush(key, cuboid->m_divX);
+        ltcKeyPush(key, cuboid->m_divY);
+        ltcKeyPush(key, cuboid->m_divZ);
+        ltcKeyPushFloat(key, cuboid->m_sizeX);
+        ltcKeyPushFloat(key, cuboid->m_sizeY);
+        ltcKeyPushFloat(key, cuboid->m_sizeZ);
+        break;
+    }
+    case LTC_SHAPE_SPHERE:
+    {
+        const LtcConfigSphere *sphere = (const LtcConfigSphere *)config;
+        ltcKeyPush(key, sphere->m_divLongitude);
+        ltcKeyPush(key, sphere->m_divLatitude);
+        ltcKeyPushFloat(key, sphere->m_radius);
+        break;
+    }
+    case LTC_SHAPE_CYLINDER:
+    {
+        const LtcConfigCylinder *cylinder = (const LtcConfigCylinder *)config;
+        ltcKeyPush(key, cylinder->m_divRadial);
+        ltcKeyPush(key, cylinder->m_divAxial);
+        ltcKeyPush(key, cylinder->m_divRings);
+        ltcKeyPushFloat(key, cylinder->m_length);
+        ltcKeyPushFloat(key, cylinder->m_radius);
+        break;
+    }
+    case LTC_SHAPE_CONE:
+    {
+        const LtcConfigCone *cone = (const LtcConfigCone *)config;
+        ltcKeyPush(key, cone->m_divRadial);
+        ltcKeyPush(key, cone->m_divAxial);
+        ltcKeyPush(key, cone->m_divRings);
+        ltcKeyPushFloat(key, cone->m_radius);
+        ltcKeyPushFloat(key, cone->m_length);
+        break;
+    }
+    case LTC_SHAPE_PRISM:
+    {
+        const LtcConfigPrism *prism = (const LtcConfigPrism *)config;
+        ltcKeyPush(key, prism->m_numFacets);
+        ltcKeyPush(key, prism->m_divPerFacetRadial);
+        ltcKeyPush(key, prism->m_divAxial);
+        ltcKeyPush(key, prism->m_divRings);
+        ltcKeyPushFloat(key, prism->m_radius);
+        ltcKeyPushFloat(key, prism->m_length);
+        break;
+    }
+    case LTC_SHAPE_PYRAMID:
+    {
+        const LtcConfigPyramid *pyramid = (const LtcConfigPyramid *)config;
+        ltcKeyPush(key, pyramid->m_numFacets);
+        ltcKeyPush(key, pyramid->m_divPerFacetRadial);
+        ltcKeyPush(key, pyramid->m_divAxial);
+        ltcKeyPush(key, pyramid->m_divRings);
+        ltcKeyPushFloat(key, pyramid->m_radius);
+        ltcKeyPushFloat(key, pyramid->m_length);
+        break;
+    }
+    case LTC_SHAPE_TUBE:
+    {
+        const LtcConfigTube *tube = (const LtcConfigTube *)config;
+        ltcKeyPush(key, tube->m_divRadial);
+        ltcKeyPush(key, tube->m_divAxial);
+        ltcKeyPush(key, tube->m_divRings);
+        ltcKeyPushFloat(key, tube->m_length);
+        ltcKeyPushFloat(key, tube->m_outerRadius);
+        ltcKeyPushFloat(key, tube->m_innerRadius);
+        break;
+    }
+    case LTC_SHAPE_CAPSULE:
+    {
+        const LtcConfigCapsule *capsule = (const LtcConfigCapsule *)config;
+        ltcKeyPush(key, capsule->m_divRadial);
+        ltcKeyPush(key, capsule->m_divAxial);
+        ltcKeyPush(key, capsule->m_divLatitude);
+        ltcKeyPushFloat(key, capsule->m_radius);
+        ltcKeyPushFloat(key, capsule->m_cylinderLength);
+        break;
+    }
+    case LTC_SHAPE_TORUS:
+    {
+        const LtcConfigTorus *torus = (const LtcConfigTorus *)config;
+        ltcKeyPush(key, torus->m_divRadialMinor);
+        ltcKeyPush(key, torus->m_divRadialMajor);
+        ltcKeyPushFloat(key, torus->m_minorRadius);
+        ltcKeyPushFloat(key, torus->m_majorRadius);
+        break;
+    }
+    case LTC_SHAPE_TORUSKNOT:
+    {
+        const LtcConfigTorusKnot *knot = (const LtcConfigTorusKnot *)config;
+        ltcKeyPush(key, knot->m_divRadial);
+        ltcKeyPush(key, knot->m_divTubular);
+        ltcKeyPushFloat(key, knot->m_radius);
+        ltcKeyPushFloat(key, knot->m_torusRadius);
+        ltcKeyPushFloat(key, knot->m_tubeRadius);
+        ltcKeyPush(key, (uint32_t)knot->m_p);
+        ltcKeyPush(key, (uint32_t)knot->m_q);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+/* The index buffer only depends on the patch grids, their effective winding
+ * and the index format, so configs of any shape with the same grids share a
+ * key. It starts with LTC_SHAPE_NONE to stay apart from the config keys. */
+static void ltcKeyPushTemplate(LtcCacheKey *key, const LtcConfig *config, const LtcLayout *layout, LtcIndexSize_t indexSize)
+{
+    ltcKeyPush(key, (uint32_t)LTC_SHAPE_NONE);
+    ltcKeyPush(key, (uint32_t)config->m_indexTopology);
+    ltcKeyPush(key, config->m_flags);
+    ltcKeyPush(key, (uint32_t)indexSize);
+    ltcKeyPush(key, layout->m_numPatches);
+    for(uint32_t p = 0; p < layout->m_numPatches; ++p)
+    {
+        const LtcPatch *patch = &layout->m_patches[p];
+        uint32_t collapse = patch->m_flags & (LTC_PATCH_COLLAPSE_V0 | LTC_PATCH_COLLAPSE_V1);
+        ltcKeyPush(key, patch->m_divU);
+        ltcKeyPush(key, patch->m_divV);
+        ltcKeyPush(key, patch->m_count | collapse << 16 | (uint32_t)ltcPatchFlipWinding(patch) << 18);
+    }
+}
+
+/* FNV-1a over the key words */
+static uint64_t ltcHashKey(const LtcCacheKey *key)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for(uint32_t w = 0; w < key->m_size; ++w)
+    {
+        for(uint32_t b = 0; b < 4; ++b)
+        {
+            hash ^= (key->m_words[w] >> (8 * b)) & 0xffu;
+            hash *= 1099511628211ull;
+        }
+    }
+    return hash;
+}
+
+static int ltcKeyEqual(const LtcCacheKey *a, const LtcCacheKey *b)
+{
+    return a->m_size == b->m_size && memcmp(a->m_words, b->m_words, a->m_size * sizeof(uint32_t)) == 0;
+}
+
+static size_t ltcAlignPayload(size_t size)
+{
+    return (size + (LTC_CACHE_PAYLOAD_ALIGNMENT - 1)) & ~(size_t)(LTC_CACHE_PAYLOAD_ALIGNMENT - 1);
+}
+
+static void ltcUnlinkUsed(LtcGeometryCache *cache, LtcCacheEntry *entry)
+{
+    if(entry->m_prevUsed)
+        entry->m_prevUsed->m_nextUsed = entry->m_nextUsed;
+    else
+        cache->m_mostRecent = entry->m_nextUsed;
+    if(entry->m_nextUsed)
+        entry->m_nextUsed->m_prevUsed = entry->m_prevUsed;
+    else
+        cache->m_leastRecent = entry->m_prevUsed;
+}
+
+static void ltcLinkMostRecent(LtcGeometryCache *cache, LtcCacheEntry *entry)
+{
+    entry->m_prevUsed = NULL;
+    entry->m_nextUsed = cache->m_mostRecent;
+    if(cache->m_mostRecent)
+        cache->m_mostRecent->m_prevUsed = entry;
+    else
+        cache->m_leastRecent = entry;
+    cache->m_mostRecent = entry;
+}
+
+/* Bytes each further reference to entry saves over a copy of its own. */
+static size_t ltcPayloadBytes(const LtcCacheEntry *entry)
+{
+    return entry->m_numBytes - ltcAlignPayload(sizeof(LtcCacheEntry));
+}
+
+static void ltcRemoveEntry(LtcGeometryCache *cache, LtcCacheEntry *entry)
+{
+    LtcCacheEntry **link = &cache->m_buckets[entry->m_hash & (cache->m_numBuckets - 1)];
+    while(*link != entry)
+        link = &(*link)->m_nextInBucket;
+    *link = entry->m_nextInBucket;
+
+    ltcUnlinkUsed(cache, entry);
+    cache->m_stats.m_numBytes -= entry->m_numBytes;
+    --cache->m_stats.m_numEntries;
+    cache->m_allocator.m_free(entry, cache->m_allocator.m_userData);
+}
+
+/* Evicts unreferenced entries, oldest first, until the cache fits its budget.
+ * Acquired entries are never evicted, so the budget can be exceeded while
+ * they are held. */
+static void ltcEnforceBudget(LtcGeometryCache *cache, size_t budget)
+{
+    LtcCacheEntry *entry = cache->m_leastRecent;
+    while(entry && cache->m_stats.m_numBytes > budget)
+    {
+        LtcCacheEntry *newer = entry->m_prevUsed;
+        if(!entry->m_refCount)
+        {
+            ltcRemoveEntry(cache, entry);
+            ++cache->m_stats.m_evictions;
+        }
+        entry = newer;
+    }
+}
+
+static void ltcGrowBuckets(LtcGeometryCache *cache)
+{
+    uint32_t numBuckets = cache->m_numBuckets * 2;
+    LtcCacheEntry **buckets = (LtcCacheEntry **)cache->m_allocator.m_alloc(numBuckets * sizeof(LtcCacheEntry *),
+                                                                            cache->m_allocator.m_userData);
+    if(!buckets)
+        return; /* keep the longer chains */
+    memset(buckets, 0, numBuckets * sizeof(LtcCacheEntry *));
+
+    for(uint32_t b = 0; b < cache->m_numBuckets; ++b)
+    {
+        LtcCacheEntry *entry = cache->m_buckets[b];
+        while(entry)
+        {
+            LtcCacheEntry *next = entry->m_nextInBucket;
+            LtcCacheEntry **bucket = &buckets[entry->m_hash & (numBuckets - 1)];
+            entry->m_nextInBucket = *bucket;
+            *bucket = entry;
+            entry = next;
+        }
+    }
+
+    cache->m_allocator.m_free(cache->m_buckets, cache->m_allocator.m_userData);
+    cache->m_buckets    = buckets;
+    cache->m_numBuckets = numBuckets;
+}
+
+LtcError_t ltcGeometryCacheCreate(const LtcAllocator *allocator, size_t byteBudget, LtcGeometryCache **outCache)
+{
+    if(!outCache)
+        return LTC_ERR_INVALIDARGS;
+
+    LtcAllocator parent;
+    if(allocator)
+        parent = *allocator;
+    else
+        ltcInitDefaultAllocator(&parent);
+    if(ltcValidateAllocator(&parent) != LTC_OK)
+        return LTC_ERR_INVALIDARGS;
+
+    LtcGeometryCache *cache = (LtcGeometryCache *)parent.m_alloc(sizeof(LtcGeometryCache), parent.m_userData);
+    if(!cache)
+        return LTC_ERR_OUTOFMEMORY;
+    cache->m_buckets = (LtcCacheEntry **)parent.m_alloc(LTC_CACHE_MIN_BUCKETS * sizeof(LtcCacheEntry *), parent.m_userData);
+    if(!cache->m_buckets)
+    {
+        parent.m_free(cache, parent.m_userData);
+        return LTC_ERR_OUTOFMEMORY;
+    }
+    memset(cache->m_buckets, 0, LTC_CACHE_MIN_BUCKETS * sizeof(LtcCacheEntry *));
+
+    cache->m_allocator   = parent;
+    cache->m_numBuckets  = LTC_CACHE_MIN_BUCKETS;
+    cache->m_mostRecent  = NULL;
+    cache->m_leastRecent = NULL;
+    cache->m_byteBudget  = byteBudget;
+    memset(&cache->m_stats, 0, sizeof(cache->m_stats));
+
+    *outCache = cache;
+    return LTC_OK;
+}
+
+void ltcGeometryCacheDestroy(LtcGeometryCache *cache)
+{
+    if(!cache)
+        return;
+
+    LtcAllocator allocator = cache->m_allocator;
+    LtcCacheEntry *entry = cache->m_mostRecent;
+    while(entry)
+    {
+        LtcCacheEntry *next = entry->m_nextUsed;
+        allocator.m_free(entry, allocator.m_userData);
+        entry = next;
+    }
+    allocator.m_free(cache->m_buckets, allocator.m_userData);
+    allocator.m_free(cache, allocator.m_userData);
+}
+
+/* Takes a reference on the entry for key if there is one. */
+static LtcCacheEntry *ltcAcquireEntry(LtcGeometryCache *cache, const LtcCacheKey *key, uint64_t hash)
+{
+    for(LtcCacheEntry *entry = cache->m_buckets[hash & (cache->m_numBuckets - 1)]; entry; entry = entry->m_nextInBucket)
+    {
+        if(entry->m_hash != hash || !ltcKeyEqual(&entry->m_key, key))
+            continue;
+
+        if(entry->m_refCount++)
+            cache->m_stats.m_numSharedBytes += ltcPayloadBytes(entry);
+        ++cache->m_stats.m_hits;
+        ltcUnlinkUsed(cache, entry);
+        ltcLinkMostRecent(cache, entry);
+        return entry;
+    }
+    return NULL;
+}
+
+/* Lays out an entry for format with its payloads behind it and generates
+ * config into it; the new entry holds one reference. */
+static LtcError_t ltcCreateEntry(LtcGeometryCache *cache, const LtcConfig *config, const LtcGeometry *format,
+                                 LtcIndexSize_t indexSize, const LtcGeometrySize *size,
+                                 const LtcCacheKey *key, uint64_t hash, LtcCacheEntry **outEntry)
+{
+    size_t numBytes = ltcAlignPayload(sizeof(LtcCacheEntry));
+    for(uint32_t slot = 0; slot < LTC_VERTEX_ATTRIB_COUNT; ++slot)
+    {
+        if(format->m_vertexAttribMask & (1u << slot))
+            numBytes += ltcAlignPayload(ltcGetVertexAttribBufferSize(&format->m_vertexAttribs[slot], size->m_numVertices));
+    }
+    numBytes += ltcAlignPayload(ltcGetIndexBufferSize(indexSize, size->m_numIndices));
+
+    uint8_t *block = (uint8_t *)cache->m_allocator.m_alloc(numBytes, cache->m_allocator.m_userData);
+    if(!block)
+        return LTC_ERR_OUTOFMEMORY;
+
+    LtcCacheEntry *entry = (LtcCacheEntry *)block;
+    uint8_t *payload = block + ltcAlignPayload(sizeof(LtcCacheEntry));
+    entry->m_geometry = *format;
+    for(uint32_t slot = 0; slot < LTC_VERTEX_ATTRIB_COUNT; ++slot)
+    {
+        LtcVertexAttribBuffer *attrib = &entry->m_geometry.m_vertexAttribs[slot];
+        if(!(format->m_vertexAttribMask & (1u << slot)))
+            continue;
+        attrib->m_buffer = payload;
+        payload += ltcAlignPayload(ltcGetVertexAttribBufferSize(attrib, size->m_numVertices));
+    }
+    if(indexSize != LTC_INDEX_SIZE_NONE)
+    {
+        entry->m_indices.m_buffer    = payload;
+        entry->m_indices.m_indexSize = indexSize;
+        ltcSetIndexBuffer(&entry->m_geometry, &entry->m_indices);
+    }
+
+    LtcError_t err = ltcGenerateGeometry(config, &entry->m_geometry);
+    if(err != LTC_OK)
+    {
+        cache->m_allocator.m_free(block, cache->m_allocator.m_userData);
+        return err;
+    }
+
+    entry->m_key      = *key;
+    entry->m_hash     = hash;
+    entry->m_numBytes = numBytes;
+    entry->m_refCount = 1;
+
+    LtcCacheEntry **bucket = &cache->m_buckets[hash & (cache->m_numBuckets - 1)];
+    entry->m_nextInBucket = *bucket;
+    *bucket = entry;
+    ltcLinkMostRecent(cache, entry);
+
+    ++cache->m_stats.m_misses;
+    ++cache->m_stats.m_numEntries;
+    cache->m_stats.m_numBytes += numBytes;
+
+    if(cache->m_stats.m_numEntries > cache->m_numBuckets)
+        ltcGrowBuckets(cache);
+    ltcEnforceBudget(cache, cache->m_byteBudget);
+
+    *outEntry = entry;
+    return LTC_OK;
+}
+
+static LtcError_t ltcValidateCacheIndexSize(LtcIndexSize_t indexSize)
+{
+    if(indexSize != LTC_INDEX_SIZE_NONE && indexSize != LTC_INDEX_SIZE_8 &&
+       indexSize != LTC_INDEX_SIZE_16 && indexSize != LTC_INDEX_SIZE_32)
+        return LTC_ERR_INVALIDARGS;
+    return LTC_OK;
+}
+
+LtcError_t ltcGeometryCacheAcquire(LtcGeometryCache *cache, const LtcConfig *config,
+                                   const LtcVertexAttribBuffer *attribFormats, uint32_t numAttribs,
+                                   LtcIndexSize_t indexSize, const LtcGeometry **outGeometry)
+{
+    if(!cache || !config || !outGeometry || (numAttribs && !attribFormats))
+        return LTC_ERR_INVALIDARGS;
+
+    /* validates the config before it is used as a key */
+    LtcGeometrySize size;
+    LtcError_t err = ltcQueryGeometrySize(config, &size);
+    if(err != LTC_OK)
+        return err;
+
+    /* the format is normalised through a geometry, which also validates it */
+    LtcGeometry format;
+    memset(&format, 0, sizeof(format));
+    for(uint32_t a = 0; a < numAttribs; ++a)
+    {
+        LtcVertexAttribBuffer attrib = attribFormats[a];
+        attrib.m_buffer          = NULL;
+        attrib.m_stride          = 0;
+        attrib.m_componentStride = 0;
+        err = ltcAddVertexAttribBuffer(&format, &attrib);
+        if(err != LTC_OK)
+            return err;
+    }
+    if(indexSize == LTC_INDEX_SIZE_AUTO)
+        indexSize = ltcGetIndexSizeForVertices(ltcIndexRange(config->m_indexTopology, size.m_numVertices));
+    if(ltcValidateCacheIndexSize(indexSize) != LTC_OK)
+        return LTC_ERR_INVALIDARGS;
+
+    LtcCacheKey key;
+    key.m_size = 0;
+    ltcKeyPushConfig(&key, config);
+    for(uint32_t slot = 0; slot < LTC_VERTEX_ATTRIB_COUNT; ++slot)
+    {
+        const LtcVertexAttribBuffer *attrib = &format.m_vertexAttribs[slot];
+        ltcKeyPush(&key, (format.m_vertexAttribMask & (1u << slot)) ?
+                   (uint32_t)attrib->m_attribSize | (uint32_t)attrib->m_format << 8 : 0);
+    }
+    ltcKeyPush(&key, (uint32_t)indexSize);
+    uint64_t hash = ltcHashKey(&key);
+
+    LtcCacheEntry *entry = ltcAcquireEntry(cache, &key, hash);
+    if(!entry)
+    {
+        err = ltcCreateEntry(cache, config, &format, indexSize, &size, &key, hash, &entry);
+        if(err != LTC_OK)
+            return err;
+    }
+
+    *outGeometry = &entry->m_geometry;
+    return LTC_OK;
+}
+
+LtcError_t ltcGeometryCacheAcquireIndices(LtcGeometryCache *cache, const LtcConfig *config, LtcIndexSize_t indexSize,
+                                          const LtcGeometry **outGeometry)
+{
+    if(!cache || !config || !outGeometry || (config->m_flags & LTC_CONFIG_FLAG_OPTIMIZE_VERTEX_FETCH))
+        return LTC_ERR_INVALIDARGS;
+
+    LtcLayout layout;
+    LtcError_t err = ltcBuildLayout(config, &layout);
+    if(err != LTC_OK)
+        return err;
+
+    LtcGeometrySize size;
+    err = ltcLayoutSize(&layout, &size);
+    if(err != LTC_OK)
+        return err;
+
+    if(indexSize == LTC_INDEX_SIZE_AUTO)
+        indexSize = ltcGetIndexSizeForVertices(ltcIndexRange(config->m_indexTopology, size.m_numVertices));
+    if(indexSize == LTC_INDEX_SIZE_NONE || ltcValidateCacheIndexSize(indexSize) != LTC_OK)
+        return LTC_ERR_INVALIDARGS;
+
+    LtcCacheKey key;
+    key.m_size = 0;
+    ltcKeyPushTemplate(&key, config, &layout, indexSize);
+    uint64_t hash = ltcHashKey(&key);
+
+    LtcCacheEntry *entry = ltcAcquireEntry(cache, &key, hash);
+    if(!entry)
+    {
+        LtcGeometry format;
+        memset(&format, 0, sizeof(format));
+        err = ltcCreateEntry(cache, config, &format, indexSize, &size, &key, hash, &entry);
+        if(err != LTC_OK)
+            return err;
+    }
+
+    *outGeometry = &entry->m_geometry;
+    return LTC_OK;
+}
+
+void ltcGeometryCacheRelease(LtcGeometryCache *cache, const LtcGeometry *geometry)
+{
+    if(!cache || !geometry)
+        return;
+
+    LtcCacheEntry *entry = (LtcCacheEntry *)geometry;
+    if(entry->m_refCount > 1)
+        cache->m_stats.m_numSharedBytes -= ltcPayloadBytes(entry);
+    if(entry->m_refCount && --entry->m_refCount == 0)
+        ltcEnforceBudget(cache, cache->m_byteBudget);
+}
+
+void ltcGeometryCacheTrim(LtcGeometryCache *cache)
+{
+    if(cache)
+        ltcEnforceBudget(cache, 0);
+}
+
+void ltcGeometryCacheGetStats(const LtcGeometryCache *cache, LtcGeometryCacheStats *outStats)
+{
+    if(cache && outStats)
+        *outStats = cache->m_stats;
+}
@@ -0,0 +1,236 @@
+#include <lattica/context.h>
+#include "internal.h"
+#include <string.h>
+
+#define LTC_CONTEXT_DEFAULT_CHUNK_SIZE (1024 * 1024)
+
+typedef struct LtcContextChunk
+{
+    struct LtcContextChunk *m_next;
+    size_t                  m_capacity;
+    size_t                  m_used;
+} LtcContextChunk;
+
+/* Every allocation is preceded by its size so realloc can copy. */
+typedef struct
+{
+    size_t m_size;
+} LtcContextHeader;
+
+struct LtcContext
+{
+    LtcAllocator     m_parent;
+    LtcAllocator     m_allocator;
+    LtcContextChunk *m_chunks;
+    LtcContextChunk *m_current;
+    size_t           m_chunkSize;
+};
+
+static size_t ltcAlignUp(size_t value)
+{
+    return (value + (LTC_CONTEXT_ALIGNMENT - 1)) & ~(size_t)(LTC_CONTEXT_ALIGNMENT - 1);
+}
+
+#define LTC_CONTEXT_CHUNK_HEADER  ltcAlignUp(sizeof(LtcContextChunk))
+#define LTC_CONTEXT_ALLOC_HEADER  ltcAlignUp(sizeof(LtcContextHeader))
+
+static uint8_t *ltcChunkData(LtcContextChunk *chunk)
+{
+    return (uint8_t *)chunk + LTC_CONTEXT_CHUNK_HEADER;
+}
+
+static void *ltcChunkAlloc(LtcContextChunk *chunk, size_t size)
+{
+    size_t needed = LTC_CONTEXT_ALLOC_HEADER + ltcAlignUp(size);
+    if(chunk->m_capacity - chunk->m_used < needed)
+        return NULL;
+
+    uint8_t *block = ltcChunkData(chunk) + chunk->m_used;
+    chunk->m_used += needed;
+    ((LtcContextHeader *)block)->m_size = size;
+    return block + LTC_CONTEXT_ALLOC_HEADER;
+}
+
+static void *ltcContextAlloc(size_t size, void *userData)
+{
+    LtcContext *context = (LtcContext *)userData;
+
+    /* walk chunks retained from before the last reset first */
+    for(LtcContextChunk *chunk = context->m_current; chunk; chunk = chunk->m_next)
+    {
+        void *ptr = ltcChunkAlloc(chunk, size);
+        if(ptr)
+        {
+            context->m_current = chunk;
+            return ptr;
+        }
+    }
+
+    size_t capacity = LTC_CONTEXT_ALLOC_HEADER + ltcAlignUp(size);
+    if(capacity < context->m_chunkSize)
+        capacity = context->m_chunkSize;
+
+    LtcContextChunk *chunk = (LtcContextChunk *)context->m_parent.m_alloc(LTC_CONTEXT_CHUNK_HEADER + capacity, context->m_parent.m_userData);
+    if(!chunk)
+        return NULL;
+    chunk->m_capacity = capacity;
+    chunk->m_used     = 0;
+
+    if(context->m_current)
+    {
+        chunk->m_next = context->m_current->m_next;
+        context->m_current->m_next = chunk;
+    }
+    else
+    {
+        chunk->m_next = NULL;
+        context->m_chunks = chunk;
+    }
+    context->m_current = chunk;
+
+    return ltcChunkAlloc(chunk, size);
+}
+
+static void *ltcContextRealloc(void *ptr, size_t size, void *userData)
+{
+    if(!ptr)
+        return ltcContextAlloc(size, userData);
+
+    LtcContext *context = (LtcContext *)userData;
+    LtcContextHeader *header = (LtcContextHeader *)((uint8_t *)ptr - LTC_CONTEXT_ALLOC_HEADER);
+    LtcContextChunk *chunk = context->m_current;
+
+    /* the most recent allocation can grow or shrink in place */
+    uint8_t *end = (uint8_t *)ptr + ltcAlignUp(header->m_size);
+    if(chunk && end == ltcChunkData(chunk) + chunk->m_used)
+    {
+        size_t used = (size_t)((uint8_t *)ptr - ltcChunkData(chunk)) + ltcAlignUp(size);
+        if(used <= chunk->m_capacity)
+        {
+            chunk->m_used = used;
+            header->m_size = size;
+            return ptr;
+        }
+    }
+
+    if(size <= header->m_size)
+    {
+        header->m_size = size;
+        return ptr;
+    }
+
+    void *moved = ltcContextAlloc(size, userData);
+    if(moved)
+        memcpy(moved, ptr, header->m_size);
+    return moved;
+}
+
+static void ltcContextFree(void *ptr, void *userData)
+{
+    (void)ptr;
+    (void)userData;
+}
+
+LtcError_t ltcContextCreate(const LtcAllocator *parentAllocator, size_t chunkSize, LtcContext **outContext)
+{
+    if(!outContext)
+        return LTC_ERR_INVALIDARGS;
+
+    LtcAllocator parent;
+    if(parentAllocator)
+        parent = *parentAllocator;
+    else
+        ltcInitDefaultAllocator(&parent);
+    if(ltcValidateAllocator(&parent) != LTC_OK)
+        return LTC_ERR_INVALIDARGS;
+
+    LtcContext *context = (LtcContext *)parent.m_alloc(sizeof(LtcContext), parent.m_userData);
+    if(!context)
+        return LTC_ERR_OUTOFMEMORY;
+
+    context->m_parent               = parent;
+    context->m_allocator.m_alloc    = ltcContextAlloc;
+    context->m_allocator.m_realloc  = ltcContextRealloc;
+    context->m_allocator.m_free     = ltcContextFree;
+    context->m_allocator.m_userData = context;
+    context->m_chunks               = NULL;
+    context->m_current              = NULL;
+    context->m_chunkSize            = chunkSize ? chunkSize : LTC_CONTEXT_DEFAULT_CHUNK_SIZE;
+
+    *outContext = context;
+    return LTC_OK;
+}
+
+void ltcContextDestroy(LtcContext *context)
+{
+    if(!context)
+        return;
+
+    LtcAllocator parent = context->m_parent;
+    LtcContextChunk *chunk = context->m_chunks;
+    while(chunk)
+    {
+        LtcContextChunk *next = chunk->m_next;
+        parent.m_free(chunk, parent.m_userData);
+        chunk = next;
+    }
+    parent.m_free(context, parent.m_userData);
+}
+
+void ltcContextReset(LtcContext *context)
+{
+    if(!context)
+        return;
+
+    for(LtcContextChunk *chunk = context->m_chunks; chunk; chunk = chunk->m_next)
+        chunk->m_used = 0;
+    context->m_current = context->m_chunks;
+}
+
+const LtcAllocator *ltcContextGetAllocator(LtcContext *context)
+{
+    return context ? &context->m_allocator : NULL;
+}
+
+LtcError_t ltcContextGenerateGeometry(LtcContext *context, const LtcConfig *config,
+                                      const LtcVertexAttribBuffer *attribFormats, uint32_t numAttribs,
+                                      LtcIndexSize_t indexSize, LtcGeometry *outGeometry)
+{
+    if(!context || !config || !outGeometry || (numAttribs && !attribFormats))
+        return LTC_ERR_INVALIDARGS;
+
+    LtcGeometrySize size;
+    LtcError_t err = ltcQueryGeometrySize(config, &size);
+    if(err != LTC_OK)
+        return err;
+
+    memset(outGeometry, 0, sizeof(LtcGeometry));
+    outGeometry->m_allocator = context->m_allocator;
+
+    for(uint32_t a = 0; a < numAttribs; ++a)
+    {
+        LtcVertexAttribBuffer attrib = attribFormats[a];
+        attrib.m_buffer = ltcContextAlloc(ltcGetVertexAttribBufferSize(&attrib, size.m_numVertices), context);
+        if(!attrib.m_buffer)
+            return LTC_ERR_OUTOFMEMORY;
+
+        err = ltcAddVertexAttribBuffer(outGeometry, &attrib);
+        if(err != LTC_OK)
+            return err;
+    }
+
+    if(indexSize != LTC_INDEX_SIZE_NONE)
+    {
+        LtcIndexBuffer *indices = (LtcIndexBuffer *)ltcContextAlloc(sizeof(LtcIndexBuffer), context);
+        if(!indices)
+            return LTC_ERR_OUTOFMEMORY;
+        /* the geometry is never regenerated, so AUTO can be settled here */
+        indices->m_indexSize = indexSize == LTC_INDEX_SIZE_AUTO ? ltcGetIndexSizeForVertices(ltcIndexRange(config->m_indexTopology, size.m_numVertices)) : indexSize;
+        indices->m_buffer    = ltcContextAlloc(ltcGetIndexBufferSize(indices->m_indexSize, size.m_numIndices), context);
+        if(!indices->m_buffer)
+            return LTC_ERR_OUTOFMEMORY;
+        ltcSetIndexBuffer(outGeometry, indices);
+    }
+
+    return ltcGenerateGeometry(config, outGeometry);
+}
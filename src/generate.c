@@ -1,5 +1,2623 @@
-#include <lattica/generate.h>
+#include "internal.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
 
-LtcError_t ltcAddVertexAttribBuffer(LtcGeometry *geometry, LtcVertexAttribBuffer *attribBuffer);
-LtcError_t ltcRemoveVertexAttribBuffer(LtcVertexAttribType_t attribType);
-LtcError_t ltcSetIndexBuffer(LtcGeometry *geometry, LtcIndexBuffer *indexBuffer);
\ No newline at end of file
+#if defined(__AVX__)
+#include <immintrin.h>
+#define LTC_SIMD_WIDTH 8
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define LTC_SIMD_WIDTH 4
+#else
+#define LTC_SIMD_WIDTH 1
+#endif
+
+static void *ltcDefaultAlloc(size_t size, void *userData)
+{
+    (void)userData;
+    return malloc(size);
+}
+
+static void *ltcDefaultRealloc(void *ptr, size_t size, void *userData)
+{
+    (void)userData;
+    return realloc(ptr, size);
+}
+
+static void ltcDefaultFree(void *ptr, void *userData)
+{
+    (void)userData;
+    free(ptr);
+}
+
+void ltcInitDefaultAllocator(LtcAllocator *allocator)
+{
+    allocator->m_alloc    = ltcDefaultAlloc;
+    allocator->m_realloc  = ltcDefaultRealloc;
+    allocator->m_free     = ltcDefaultFree;
+    allocator->m_userData = NULL;
+}
+
+static const LtcAllocator s_defaultAllocator = { ltcDefaultAlloc, ltcDefaultRealloc, ltcDefaultFree, NULL };
+
+const LtcAllocator *ltcGetAllocator(const LtcConfig *config)
+{
+    return config->m_allocator ? config->m_allocator : &s_defaultAllocator;
+}
+
+LtcError_t ltcValidateAllocator(const LtcAllocator *allocator)
+{
+    if(!allocator->m_alloc || !allocator->m_realloc || !allocator->m_free)
+        return LTC_ERR_INVALIDARGS;
+    return LTC_OK;
+}
+
+void ltcInitDefaultConfig(LtcConfig *config)
+{
+    config->m_shape         = LTC_SHAPE_NONE;
+    config->m_windingOrder  = LTC_WINDING_ORDER_COUNTER_CLOCKWISE;
+    config->m_indexTopology = LTC_INDEX_TOPOLOGY_TRIANGLE_LIST;
+    config->m_uvMapping     = LTC_UVMAPPING_NONE;
+    config->m_flags         = LTC_CONFIG_FLAG_NONE;
+    config->m_allocator     = NULL;
+    config->m_taskInterface = NULL;
+}
+
+void ltcInitDefaultConfigPlane(LtcConfigPlane *config)
+{
+    ltcInitDefaultConfig(&config->m_common);
+    config->m_common.m_shape = LTC_SHAPE_PLANE;
+    config->m_divX  = 1;
+    config->m_divY  = 1;
+    config->m_sizeX = 1.0f;
+    config->m_sizeY = 1.0f;
+}
+
+void ltcInitDefaultConfigCuboid(LtcConfigCuboid *config)
+{
+    ltcInitDefaultConfig(&config->m_common);
+    config->m_common.m_shape = LTC_SHAPE_CUBOID;
+    config->m_divX  = 1;
+    config->m_divY  = 1;
+    config->m_divZ  = 1;
+    config->m_sizeX = 1.0f;
+    config->m_sizeY = 1.0f;
+    config->m_sizeZ = 1.0f;
+}
+
+void ltcInitDefaultConfigSphere(LtcConfigSphere *config)
+{
+    ltcInitDefaultConfig(&config->m_common);
+    config->m_common.m_shape = LTC_SHAPE_SPHERE;
+    config->m_divLongitude = 32;
+    config->m_divLatitude  = 16;
+    config->m_radius       = 0.5f;
+}
+
+void ltcInitDefaultConfigCylinder(LtcConfigCylinder *config)
+{
+    ltcInitDefaultConfig(&config->m_common);
+    config->m_common.m_shape = LTC_SHAPE_CYLINDER;
+    config->m_divRadial = 32;
+    config->m_divAxial  = 1;
+    config->m_divRings  = 1;
+    config->m_length    = 1.0f;
+    config->m_radius    = 0.5f;
+}
+
+void ltcInitDefaultConfigCone(LtcConfigCone *config)
+{
+    ltcInitDefaultConfig(&config->m_common);
+    config->m_common.m_shape = LTC_SHAPE_CONE;
+    config->m_divRadial = 32;
+    config->m_divAxial  = 1;
+    config->m_divRings  = 1;
+    config->m_radius    = 0.5f;
+    config->m_length    = 1.0f;
+}
+
+void ltcInitDefaultConfigPrism(LtcConfigPrism *config)
+{
+    ltcInitDefaultConfig(&config->m_common);
+    config->m_common.m_shape = LTC_SHAPE_PRISM;
+    config->m_numFacets         = 6;
+    config->m_divPerFacetRadial = 1;
+    config->m_divAxial          = 1;
+    config->m_divRings          = 1;
+    config->m_radius            = 0.5f;
+    config->m_length            = 1.0f;
+}
+
+void ltcInitDefaultConfigPyramid(LtcConfigPyramid *config)
+{
+    ltcInitDefaultConfig(&config->m_common);
+    config->m_common.m_shape = LTC_SHAPE_PYRAMID;
+    config->m_numFacets         = 4;
+    config->m_divPerFacetRadial = 1;
+    config->m_divAxial          = 1;
+    config->m_divRings          = 1;
+    config->m_radius            = 0.5f;
+    config->m_length            = 1.0f;
+}
+
+void ltcInitDefaultConfigTube(LtcConfigTube *config)
+{
+    ltcInitDefaultConfig(&config->m_common);
+    config->m_common.m_shape = LTC_SHAPE_TUBE;
+    config->m_divRadial   = 32;
+    config->m_divAxial    = 1;
+    config->m_divRings    = 1;
+    config->m_length      = 1.0f;
+    config->m_outerRadius = 0.5f;
+    config->m_innerRadius = 0.25f;
+}
+
+void ltcInitDefaultConfigCapsule(LtcConfigCapsule *config)
+{
+    ltcInitDefaultConfig(&config->m_common);
+    config->m_common.m_shape = LTC_SHAPE_CAPSULE;
+    config->m_divRadial      = 32;
+    config->m_divAxial       = 1;
+    config->m_divLatitude    = 8;
+    config->m_radius         = 0.25f;
+    config->m_cylinderLength = 0.5f;
+}
+
+void ltcInitDefaultConfigTorus(LtcConfigTorus *config)
+{
+    ltcInitDefaultConfig(&config->m_common);
+    config->m_common.m_shape = LTC_SHAPE_TORUS;
+    config->m_divRadialMinor = 16;
+    config->m_divRadialMajor = 32;
+    config->m_minorRadius    = 0.125f;
+    config->m_majorRadius    = 0.375f;
+}
+
+void ltcInitDefaultConfigTorusKnot(LtcConfigTorusKnot *config)
+{
+    ltcInitDefaultConfig(&config->m_common);
+    config->m_common.m_shape = LTC_SHAPE_TORUSKNOT;
+    config->m_divRadial   = 16;
+    config->m_divTubular  = 128;
+    config->m_radius      = 0.3f;
+    config->m_torusRadius = 0.125f;
+    config->m_tubeRadius  = 0.075f;
+    config->m_p           = 2;
+    config->m_q           = 3;
+}
+
+static int ltcGetVertexAttribSlot(LtcVertexAttribType_t attribType)
+{
+    switch(attribType)
+    {
+    case LTC_VERTEX_ATTRIB_TYPE_POSITION:  return 0;
+    case LTC_VERTEX_ATTRIB_TYPE_NORMAL:    return 1;
+    case LTC_VERTEX_ATTRIB_TYPE_TEXCOORD:  return 2;
+    case LTC_VERTEX_ATTRIB_TYPE_TANGENT:   return 3;
+    case LTC_VERTEX_ATTRIB_TYPE_BITANGENT: return 4;
+    case LTC_VERTEX_ATTRIB_TYPE_QTANGENT:  return 5;
+    default:                               return -1;
+    }
+}
+
+LtcError_t ltcAddVertexAttribBuffer(LtcGeometry *geometry, const LtcVertexAttribBuffer *attribBuffer)
+{
+    if(!geometry || !attribBuffer)
+        return LTC_ERR_INVALIDARGS;
+
+    int slot = ltcGetVertexAttribSlot(attribBuffer->m_attribType);
+    if(slot < 0 || (geometry->m_vertexAttribMask & (uint32_t)attribBuffer->m_attribType))
+        return LTC_ERR_INVALIDARGS;
+
+    geometry->m_vertexAttribs[slot] = *attribBuffer;
+    geometry->m_vertexAttribMask |= (uint32_t)attribBuffer->m_attribType;
+    memset(geometry->m_topology, 0, sizeof(geometry->m_topology));
+    return LTC_OK;
+}
+
+LtcError_t ltcRemoveVertexAttribBuffer(LtcGeometry *geometry, LtcVertexAttribType_t attribType)
+{
+    if(!geometry)
+        return LTC_ERR_INVALIDARGS;
+
+    int slot = ltcGetVertexAttribSlot(attribType);
+    if(slot < 0 || !(geometry->m_vertexAttribMask & (uint32_t)attribType))
+        return LTC_ERR_INVALIDARGS;
+
+    LtcVertexAttribBuffer *attrib = &geometry->m_vertexAttribs[slot];
+    if(geometry->m_allocatedBuffers & (uint32_t)attribType)
+    {
+        geometry->m_allocator.m_free(attrib->m_buffer, geometry->m_allocator.m_userData);
+        geometry->m_allocatedBuffers &= ~(uint32_t)attribType;
+    }
+    attrib->m_buffer = NULL;
+    geometry->m_vertexAttribMask &= ~(uint32_t)attribType;
+    memset(geometry->m_topology, 0, sizeof(geometry->m_topology));
+    return LTC_OK;
+}
+
+LtcVertexAttribBuffer *ltcGetVertexAttribBuffer(LtcGeometry *geometry, LtcVertexAttribType_t attribType)
+{
+    int slot = ltcGetVertexAttribSlot(attribType);
+    if(!geometry || slot < 0 || !(geometry->m_vertexAttribMask & (uint32_t)attribType))
+        return NULL;
+    return &geometry->m_vertexAttribs[slot];
+}
+
+LtcError_t ltcSetIndexBuffer(LtcGeometry *geometry, LtcIndexBuffer *indexBuffer)
+{
+    if(!geometry)
+        return LTC_ERR_INVALIDARGS;
+
+    geometry->m_indices = indexBuffer;
+    memset(geometry->m_topology, 0, sizeof(geometry->m_topology));
+    return LTC_OK;
+}
+
+void ltcFreeGeometry(LtcGeometry *geometry)
+{
+    if(!geometry || !geometry->m_allocatedBuffers)
+        return;
+
+    const LtcAllocator *allocator = &geometry->m_allocator;
+    for(uint32_t slot = 0; slot < LTC_VERTEX_ATTRIB_COUNT; ++slot)
+    {
+        if(geometry->m_allocatedBuffers & (1u << slot))
+        {
+            allocator->m_free(geometry->m_vertexAttribs[slot].m_buffer, allocator->m_userData);
+            geometry->m_vertexAttribs[slot].m_buffer = NULL;
+        }
+    }
+    if(geometry->m_indices && (geometry->m_allocatedBuffers & LTC_ALLOCATED_INDEX_BUFFER))
+    {
+        allocator->m_free(geometry->m_indices->m_buffer, allocator->m_userData);
+        geometry->m_indices->m_buffer = NULL;
+    }
+    geometry->m_allocatedBuffers = 0;
+}
+
+/* ---- vector helpers ---------------------------------------------------- */
+
+static void ltcSet3(float *out, float x, float y, float z)
+{
+    out[0] = x;
+    out[1] = y;
+    out[2] = z;
+}
+
+static void ltcCross(const float *a, const float *b, float *out)
+{
+    float x = a[1] * b[2] - a[2] * b[1];
+    float y = a[2] * b[0] - a[0] * b[2];
+    float z = a[0] * b[1] - a[1] * b[0];
+    ltcSet3(out, x, y, z);
+}
+
+static void ltcNormalize(float *v)
+{
+    float len = sqrtf(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+    if(len > 0.0f)
+    {
+        v[0] /= len;
+        v[1] /= len;
+        v[2] /= len;
+    }
+}
+
+/* Point on a ring around +Y. Angle 0 faces +Z and increases towards +X, which
+ * makes (tangent x up) point outwards for every surface of revolution. */
+static void ltcRing(float angle, float *outDir, float *outTangent)
+{
+    float s = sinf(angle);
+    float c = cosf(angle);
+    ltcSet3(outDir, s, 0.0f, c);
+    ltcSet3(outTangent, c, 0.0f, -s);
+}
+
+static float ltcParam(uint32_t i, uint32_t div)
+{
+    return (float)i / (float)div;
+}
+
+/* Corner k of a regular polygon with the given circumradius. */
+static void ltcPolygonCorner(uint32_t k, uint32_t numSides, float radius, float *out)
+{
+    float angle = 2.0f * LTC_PI * (float)(k % numSides) / (float)numSides;
+    ltcSet3(out, radius * sinf(angle), 0.0f, radius * cosf(angle));
+}
+
+/* Point on the boundary of a regular polygon subdivided into divPerSide
+ * segments per side; i runs over [0, numSides * divPerSide]. */
+static void ltcPolygonEdge(uint32_t i, uint32_t numSides, uint32_t divPerSide, float radius, float *outPoint, float *outTangent)
+{
+    uint32_t side = i / divPerSide;
+    uint32_t step = i % divPerSide;
+    if(side == numSides)
+    {
+        side = numSides - 1;
+        step = divPerSide;
+    }
+
+    float c0[3], c1[3];
+    ltcPolygonCorner(side, numSides, radius, c0);
+    ltcPolygonCorner(side + 1, numSides, radius, c1);
+
+    float t = ltcParam(step, divPerSide);
+    for(int c = 0; c < 3; ++c)
+    {
+        outPoint[c]   = c0[c] + (c1[c] - c0[c]) * t;
+        outTangent[c] = c1[c] - c0[c];
+    }
+    ltcNormalize(outTangent);
+}
+
+/* ---- shape evaluators -------------------------------------------------- */
+
+static void ltcEvalPlane(const LtcPatch *patch, uint32_t copy, uint32_t i, uint32_t j, LtcSurfacePoint *out)
+{
+    const LtcConfigPlane *config = (const LtcConfigPlane *)patch->m_config;
+    (void)copy;
+
+    ltcSet3(out->m_position,
+            (ltcParam(i, patch->m_divU) - 0.5f) * config->m_sizeX,
+            (ltcParam(j, patch->m_divV) - 0.5f) * config->m_sizeY,
+            0.0f);
+    ltcSet3(out->m_normal, 0.0f, 0.0f, 1.0f);
+    ltcSet3(out->m_tangent, 1.0f, 0.0f, 0.0f);
+}
+
+static void ltcEvalCuboid(const LtcPatch *patch, uint32_t copy, uint32_t i, uint32_t j, LtcSurfacePoint *out)
+{
+    /* normal, u axis and v axis per face, with u x v == normal */
+    static const float faces[6][3][3] =
+    {
+        { {  1, 0, 0 }, {  0, 0, -1 }, { 0, 1,  0 } },
+        { { -1, 0, 0 }, {  0, 0,  1 }, { 0, 1,  0 } },
+        { {  0, 1, 0 }, {  1, 0,  0 }, { 0, 0, -1 } },
+        { {  0,-1, 0 }, {  1, 0,  0 }, { 0, 0,  1 } },
+        { {  0, 0, 1 }, {  1, 0,  0 }, { 0, 1,  0 } },
+        { {  0, 0,-1 }, { -1, 0,  0 }, { 0, 1,  0 } },
+    };
+    const LtcConfigCuboid *config = (const LtcConfigCuboid *)patch->m_config;
+    const float (*face)[3] = faces[(int)patch->m_side];
+    const float size[3] = { config->m_sizeX, config->m_sizeY, config->m_sizeZ };
+    float u = ltcParam(i, patch->m_divU) - 0.5f;
+    float v = ltcParam(j, patch->m_divV) - 0.5f;
+    (void)copy;
+
+    for(int c = 0; c < 3; ++c)
+        out->m_position[c] = (face[0][c] * 0.5f + face[1][c] * u + face[2][c] * v) * size[c];
+    ltcSet3(out->m_normal, face[0][0], face[0][1], face[0][2]);
+    ltcSet3(out->m_tangent, face[1][0], face[1][1], face[1][2]);
+}
+
+/* Sphere section between polar angles m_side and m_side + PI * sweep, centred
+ * at an axial offset. Shared by the sphere and the capsule caps. */
+static void ltcEvalSphereSection(const LtcPatch *patch, float radius, float centreY, float sweep, uint32_t i, uint32_t j, LtcSurfacePoint *out)
+{
+    float dir[3];
+    ltcRing(2.0f * LTC_PI * ltcParam(i, patch->m_divU), dir, out->m_tangent);
+
+    float phi = patch->m_side - LTC_PI * sweep * ltcParam(j, patch->m_divV);
+    float s = sinf(phi);
+    float c = cosf(phi);
+    ltcSet3(out->m_normal, dir[0] * s, c, dir[2] * s);
+    ltcSet3(out->m_position,
+            out->m_normal[0] * radius,
+            out->m_normal[1] * radius + centreY,
+            out->m_normal[2] * radius);
+}
+
+static void ltcEvalSphere(const LtcPatch *patch, uint32_t copy, uint32_t i, uint32_t j, LtcSurfacePoint *out)
+{
+    const LtcConfigSphere *config = (const LtcConfigSphere *)patch->m_config;
+    (void)copy;
+    ltcEvalSphereSection(patch, config->m_radius, 0.0f, 1.0f, i, j, out);
+}
+
+static void ltcEmitSphere(const LtcPatch *patch, uint32_t copy, uint32_t rowBegin, uint32_t rowEnd,
+                          const LtcVertexWriter *writer, uint32_t firstVertex);
+
+/* Open cylinder wall, radius r, from y0 to y1. m_side of -1 faces inwards. */
+static void ltcEvalWall(const LtcPatch *patch, float radius, float y0, float y1, uint32_t i, uint32_t j, LtcSurfacePoint *out)
+{
+    float dir[3];
+    ltcRing(2.0f * LTC_PI * ltcParam(i, patch->m_divU), dir, out->m_tangent);
+
+    ltcSet3(out->m_position, dir[0] * radius, y0 + (y1 - y0) * ltcParam(j, patch->m_divV), dir[2] * radius);
+    ltcSet3(out->m_normal, dir[0] * patch->m_side, 0.0f, dir[2] * patch->m_side);
+}
+
+/* Flat annulus at height y from radius r0 (v = 0) to r1 (v = 1), facing
+ * +Y when m_side is 1 and -Y when it is -1. */
+static void ltcEvalDisk(const LtcPatch *patch, float y, float r0, float r1, uint32_t i, uint32_t j, LtcSurfacePoint *out)
+{
+    float dir[3];
+    ltcRing(2.0f * LTC_PI * ltcParam(i, patch->m_divU), dir, out->m_tangent);
+
+    float radius = r0 + (r1 - r0) * ltcParam(j, patch->m_divV);
+    ltcSet3(out->m_position, dir[0] * radius, y, dir[2] * radius);
+    ltcSet3(out->m_normal, 0.0f, patch->m_side, 0.0f);
+}
+
+static void ltcEvalCylinderWall(const LtcPatch *patch, uint32_t copy, uint32_t i, uint32_t j, LtcSurfacePoint *out)
+{
+    const LtcConfigCylinder *config = (const LtcConfigCylinder *)patch->m_config;
+    float h = config->m_length * 0.5f;
+    (void)copy;
+    ltcEvalWall(patch, config->m_radius, -h, h, i, j, out);
+}
+
+static void ltcEvalCylinderCap(const LtcPatch *patch, uint32_t copy, uint32_t i, uint32_t j, LtcSurfacePoint *out)
+{
+    const LtcConfigCylinder *config = (const LtcConfigCylinder *)patch->m_config;
+    (void)copy;
+    ltcEvalDisk(patch, config->m_length * 0.5f * patch->m_side, config->m_radius, 0.0f, i, j, out);
+}
+
+static void ltcEvalConeWall(const LtcPatch *patch, uint32_t copy, uint32_t i, uint32_t j, LtcSurfacePoint *out)
+{
+    const LtcConfigCone *config = (const LtcConfigCone *)patch->m_config;
+    float dir[3];
+    float v = ltcParam(j, patch->m_divV);
+    (void)copy;
+
+    ltcRing(2.0f * LTC_PI * ltcParam(i, patch->m_divU), dir, out->m_tangent);
+    float radius = config->m_radius * (1.0f - v);
+    ltcSet3(out->m_position, dir[0] * radius, config->m_length * (v - 0.5f), dir[2] * radius);
+    ltcSet3(out->m_normal, dir[0] * config->m_length, config->m_radius, dir[2] * config->m_length);
+    ltcNormalize(out->m_normal);
+}
+
+static void ltcEvalConeCap(const LtcPatch *patch, uint32_t copy, uint32_t i, uint32_t j, LtcSurfacePoint *out)
+{
+    const LtcConfigCone *config = (const LtcConfigCone *)patch->m_config;
+    (void)copy;
+    ltcEvalDisk(patch, -config->m_length * 0.5f, config->m_radius, 0.0f, i, j, out);
+}
+
+/* Polygon cap shared by prisms and pyramids. */
+static void ltcEvalPolygonCap(const LtcPatch *patch, uint32_t numSides, float radius, float y, uint32_t i, uint32_t j, LtcSurfacePoint *out)
+{
+    float edge[3];
+    ltcPolygonEdge(i, numSides, patch->m_divU / numSides, radius, edge, out->m_tangent);
+
+    float scale = 1.0f - ltcParam(j, patch->m_divV);
+    ltcSet3(out->m_position, edge[0] * scale, y, edge[2] * scale);
+    ltcSet3(out->m_normal, 0.0f, patch->m_side, 0.0f);
+}
+
+static void ltcEvalPrismFacet(const LtcPatch *patch, uint32_t copy, uint32_t i, uint32_t j, LtcSurfacePoint *out)
+{
+    const LtcConfigPrism *config = (const LtcConfigPrism *)patch->m_config;
+    float c0[3], c1[3];
+    float u = ltcParam(i, patch->m_divU);
+    float h = config->m_length * 0.5f;
+
+    ltcPolygonCorner(copy, config->m_numFacets, config->m_radius, c0);
+    ltcPolygonCorner(copy + 1, config->m_numFacets, config->m_radius, c1);
+    ltcSet3(out->m_position,
+            c0[0] + (c1[0] - c0[0]) * u,
+            -h + config->m_length * ltcParam(j, patch->m_divV),
+            c0[2] + (c1[2] - c0[2]) * u);
+    ltcSet3(out->m_tangent, c1[0] - c0[0], 0.0f, c1[2] - c0[2]);
+    ltcNormalize(out->m_tangent);
+    ltcSet3(out->m_normal, -out->m_tangent[2], 0.0f, out->m_tangent[0]);
+}
+
+static void ltcEvalPrismCap(const LtcPatch *patch, uint32_t copy, uint32_t i, uint32_t j, LtcSurfacePoint *out)
+{
+    const LtcConfigPrism *config = (const LtcConfigPrism *)patch->m_config;
+    (void)copy;
+    ltcEvalPolygonCap(patch, config->m_numFacets, config->m_radius, config->m_length * 0.5f * patch->m_side, i, j, out);
+}
+
+static void ltcEvalPyramidFacet(const LtcPatch *patch, uint32_t copy, uint32_t i, uint32_t j, LtcSurfacePoint *out)
+{
+    const LtcConfigPyramid *config = (const LtcConfigPyramid *)patch->m_config;
+    float c0[3], c1[3], up[3];
+    float u = ltcParam(i, patch->m_divU);
+    float v = ltcParam(j, patch->m_divV);
+    float h = config->m_length * 0.5f;
+
+    ltcPolygonCorner(copy, config->m_numFacets, config->m_radius, c0);
+    ltcPolygonCorner(copy + 1, config->m_numFacets, config->m_radius, c1);
+    ltcSet3(out->m_position,
+            (c0[0] + (c1[0] - c0[0]) * u) * (1.0f - v),
+            -h + config->m_length * v,
+            (c0[2] + (c1[2] - c0[2]) * u) * (1.0f - v));
+
+    ltcSet3(out->m_tangent, c1[0] - c0[0], 0.0f, c1[2] - c0[2]);
+    ltcSet3(up, -(c0[0] + c1[0]) * 0.5f, config->m_length, -(c0[2] + c1[2]) * 0.5f);
+    ltcCross(out->m_tangent, up, out->m_normal);
+    ltcNormalize(out->m_tangent);
+    ltcNormalize(out->m_normal);
+}
+
+static void ltcEvalPyramidCap(const LtcPatch *patch, uint32_t copy, uint32_t i, uint32_t j, LtcSurfacePoint *out)
+{
+    const LtcConfigPyramid *config = (const LtcConfigPyramid *)patch->m_config;
+    (void)copy;
+    ltcEvalPolygonCap(patch, config->m_numFacets, config->m_radius, -config->m_length * 0.5f, i, j, out);
+}
+
+static void ltcEvalTubeWall(const LtcPatch *patch, uint32_t copy, uint32_t i, uint32_t j, LtcSurfacePoint *out)
+{
+    const LtcConfigTube *config = (const LtcConfigTube *)patch->m_config;
+    float h = config->m_length * 0.5f;
+    float radius = patch->m_side > 0.0f ? config->m_outerRadius : config->m_innerRadius;
+    (void)copy;
+    ltcEvalWall(patch, radius, -h, h, i, j, out);
+}
+
+static void ltcEvalTubeCap(const LtcPatch *patch, uint32_t copy, uint32_t i, uint32_t j, LtcSurfacePoint *out)
+{
+    const LtcConfigTube *config = (const LtcConfigTube *)patch->m_config;
+    (void)copy;
+    ltcEvalDisk(patch, config->m_length * 0.5f * patch->m_side, config->m_outerRadius, config->m_innerRadius, i, j, out);
+}
+
+static void ltcEvalCapsuleWall(const LtcPatch *patch, uint32_t copy, uint32_t i, uint32_t j, LtcSurfacePoint *out)
+{
+    const LtcConfigCapsule *config = (const LtcConfigCapsule *)patch->m_config;
+    float h = config->m_cylinderLength * 0.5f;
+    (void)copy;
+    ltcEvalWall(patch, config->m_radius, -h, h, i, j, out);
+}
+
+static void ltcEvalCapsuleCap(const LtcPatch *patch, uint32_t copy, uint32_t i, uint32_t j, LtcSurfacePoint *out)
+{
+    const LtcConfigCapsule *config = (const LtcConfigCapsule *)patch->m_config;
+    float h = config->m_cylinderLength * 0.5f;
+    (void)copy;
+    ltcEvalSphereSection(patch, config->m_radius, patch->m_side > LTC_PI * 0.75f ? -h : h, 0.5f, i, j, out);
+}
+
+static void ltcEvalTorus(const LtcPatch *patch, uint32_t copy, uint32_t i, uint32_t j, LtcSurfacePoint *out)
+{
+    const LtcConfigTorus *config = (const LtcConfigTorus *)patch->m_config;
+    float dir[3];
+    float phi = 2.0f * LTC_PI * ltcParam(j, patch->m_divV);
+    float s = sinf(phi);
+    float c = cosf(phi);
+    (void)copy;
+
+    ltcRing(2.0f * LTC_PI * ltcParam(i, patch->m_divU), dir, out->m_tangent);
+    ltcSet3(out->m_normal, dir[0] * c, s, dir[2] * c);
+    float ring = config->m_majorRadius + config->m_minorRadius * c;
+    ltcSet3(out->m_position, dir[0] * ring, config->m_minorRadius * s, dir[2] * ring);
+}
+
+static void ltcEvalTorusKnot(const LtcPatch *patch, uint32_t copy, uint32_t i, uint32_t j, LtcSurfacePoint *out)
+{
+    const LtcConfigTorusKnot *config = (const LtcConfigTorusKnot *)patch->m_config;
+    float t = 2.0f * LTC_PI * ltcParam(i, patch->m_divU);
+    float p = (float)config->m_p;
+    float q = (float)config->m_q;
+    float a = config->m_torusRadius;
+    float dir[3], dirTangent[3];
+    (void)copy;
+
+    /* centre line winds p times around the axis and q times through the hole
+     * of a torus with radii (m_radius, m_torusRadius) */
+    ltcRing(p * t, dir, dirTangent);
+    float sq = sinf(q * t);
+    float cq = cosf(q * t);
+    float ring = config->m_radius + a * cq;
+    float centre[3] = { dir[0] * ring, a * sq, dir[2] * ring };
+
+    float tangent[3];
+    for(int c = 0; c < 3; ++c)
+        tangent[c] = dirTangent[c] * ring * p - dir[c] * a * q * sq;
+    tangent[1] = a * q * cq;
+    ltcNormalize(tangent);
+
+    /* frame: N is the centre direction made orthogonal to the curve */
+    float d = centre[0] * tangent[0] + centre[1] * tangent[1] + centre[2] * tangent[2];
+    float n[3], b[3];
+    for(int c = 0; c < 3; ++c)
+        n[c] = centre[c] - tangent[c] * d;
+    ltcNormalize(n);
+    ltcCross(n, tangent, b);
+
+    float phi = 2.0f * LTC_PI * ltcParam(j, patch->m_divV);
+    float s = sinf(phi);
+    float c = cosf(phi);
+    for(int k = 0; k < 3; ++k)
+    {
+        out->m_normal[k]   = n[k] * c + b[k] * s;
+        out->m_position[k] = centre[k] + out->m_normal[k] * config->m_tubeRadius;
+        out->m_tangent[k]  = tangent[k];
+    }
+}
+
+/* ---- layout ------------------------------------------------------------ */
+
+static void ltcAddPatch(LtcLayout *layout, const LtcConfig *config, LtcPatchEvalFn eval, uint32_t divU, uint32_t divV, uint32_t count, uint32_t flags, float side)
+{
+    LtcPatch *patch = &layout->m_patches[layout->m_numPatches++];
+    patch->m_eval   = eval;
+    patch->m_emit   = NULL;
+    patch->m_config = config;
+    patch->m_divU   = divU;
+    patch->m_divV   = divV;
+    patch->m_count  = count;
+    patch->m_flags  = flags;
+    patch->m_side   = side;
+}
+
+LtcError_t ltcBuildLayout(const LtcConfig *config, LtcLayout *layout)
+{
+    layout->m_numPatches = 0;
+
+    if(config->m_windingOrder != LTC_WINDING_ORDER_COUNTER_CLOCKWISE &&
+       config->m_windingOrder != LTC_WINDING_ORDER_CLOCKWISE)
+        return LTC_ERR_INVALIDARGS;
+    /* reordering triangles would break up the strips */
+    if(config->m_indexTopology != LTC_INDEX_TOPOLOGY_TRIANGLE_LIST &&
+       (config->m_indexTopology != LTC_INDEX_TOPOLOGY_TRIANGLE_STRIP || config->m_flags))
+        return LTC_ERR_INVALIDARGS;
+    if(config->m_uvMapping != LTC_UVMAPPING_NONE)
+        return LTC_ERR_NOSUPPORT;
+
+    switch(config->m_shape)
+    {
+    case LTC_SHAPE_PLANE:
+    {
+        const LtcConfigPlane *plane = (const LtcConfigPlane *)config;
+        if(plane->m_divX < 1 || plane->m_divY < 1 || !(plane->m_sizeX > 0.0f) || !(plane->m_sizeY > 0.0f))
+            return LTC_ERR_INVALIDARGS;
+        ltcAddPatch(layout, config, ltcEvalPlane, plane->m_divX, plane->m_divY, 1, 0, 0.0f);
+        break;
+    }
+    case LTC_SHAPE_CUBOID:
+    {
+        const LtcConfigCuboid *cuboid = (const LtcConfigCuboid *)config;
+        if(cuboid->m_divX < 1 || cuboid->m_divY < 1 || cuboid->m_divZ < 1 ||
+           !(cuboid->m_sizeX > 0.0f) || !(cuboid->m_sizeY > 0.0f) || !(cuboid->m_sizeZ > 0.0f))
+            return LTC_ERR_INVALIDARGS;
+        ltcAddPatch(layout, config, ltcEvalCuboid, cuboid->m_divZ, cuboid->m_divY, 1, 0, 0.0f);
+        ltcAddPatch(layout, config, ltcEvalCuboid, cuboid->m_divZ, cuboid->m_divY, 1, 0, 1.0f);
+        ltcAddPatch(layout, config, ltcEvalCuboid, cuboid->m_divX, cuboid->m_divZ, 1, 0, 2.0f);
+        ltcAddPatch(layout, config, ltcEvalCuboid, cuboid->m_divX, cuboid->m_divZ, 1, 0, 3.0f);
+        ltcAddPatch(layout, config, ltcEvalCuboid, cuboid->m_divX, cuboid->m_divY, 1, 0, 4.0f);
+        ltcAddPatch(layout, config, ltcEvalCuboid, cuboid->m_divX, cuboid->m_divY, 1, 0, 5.0f);
+        break;
+    }
+    case LTC_SHAPE_SPHERE:
+    {
+        const LtcConfigSphere *sphere = (const LtcConfigSphere *)config;
+        if(sphere->m_divLongitude < 3 || sphere->m_divLatitude < 2 || !(sphere->m_radius > 0.0f))
+            return LTC_ERR_INVALIDARGS;
+        ltcAddPatch(layout, config, ltcEvalSphere, sphere->m_divLongitude, sphere->m_divLatitude, 1,
+                    LTC_PATCH_COLLAPSE_V0 | LTC_PATCH_COLLAPSE_V1, LTC_PI);
+        layout->m_patches[0].m_emit = ltcEmitSphere;
+        break;
+    }
+    case LTC_SHAPE_CYLINDER:
+    {
+        const LtcConfigCylinder *cylinder = (const LtcConfigCylinder *)config;
+        if(cylinder->m_divRadial < 3 || cylinder->m_divAxial < 1 || cylinder->m_divRings < 1 ||
+           !(cylinder->m_radius > 0.0f) || !(cylinder->m_length > 0.0f))
+            return LTC_ERR_INVALIDARGS;
+        ltcAddPatch(layout, config, ltcEvalCylinderWall, cylinder->m_divRadial, cylinder->m_divAxial, 1, 0, 1.0f);
+        ltcAddPatch(layout, config, ltcEvalCylinderCap, cylinder->m_divRadial, cylinder->m_divRings, 1, LTC_PATCH_COLLAPSE_V1, 1.0f);
+        ltcAddPatch(layout, config, ltcEvalCylinderCap, cylinder->m_divRadial, cylinder->m_divRings, 1, LTC_PATCH_COLLAPSE_V1 | LTC_PATCH_FLIP, -1.0f);
+        break;
+    }
+    case LTC_SHAPE_CONE:
+    {
+        const LtcConfigCone *cone = (const LtcConfigCone *)config;
+        if(cone->m_divRadial < 3 || cone->m_divAxial < 1 || cone->m_divRings < 1 ||
+           !(cone->m_radius > 0.0f) || !(cone->m_length > 0.0f))
+            return LTC_ERR_INVALIDARGS;
+        ltcAddPatch(layout, config, ltcEvalConeWall, cone->m_divRadial, cone->m_divAxial, 1, LTC_PATCH_COLLAPSE_V1, 1.0f);
+        ltcAddPatch(layout, config, ltcEvalConeCap, cone->m_divRadial, cone->m_divRings, 1, LTC_PATCH_COLLAPSE_V1 | LTC_PATCH_FLIP, -1.0f);
+        break;
+    }
+    case LTC_SHAPE_PRISM:
+    {
+        const LtcConfigPrism *prism = (const LtcConfigPrism *)config;
+        if(prism->m_numFacets < 3 || prism->m_divPerFacetRadial < 1 || prism->m_divAxial < 1 || prism->m_divRings < 1 ||
+           !(prism->m_radius > 0.0f) || !(prism->m_length > 0.0f))
+            return LTC_ERR_INVALIDARGS;
+        uint32_t divCap = (uint32_t)prism->m_numFacets * prism->m_divPerFacetRadial;
+        ltcAddPatch(layout, config, ltcEvalPrismFacet, prism->m_divPerFacetRadial, prism->m_divAxial, prism->m_numFacets, 0, 1.0f);
+        ltcAddPatch(layout, config, ltcEvalPrismCap, divCap, prism->m_divRings, 1, LTC_PATCH_COLLAPSE_V1, 1.0f);
+        ltcAddPatch(layout, config, ltcEvalPrismCap, divCap, prism->m_divRings, 1, LTC_PATCH_COLLAPSE_V1 | LTC_PATCH_FLIP, -1.0f);
+        break;
+    }
+    case LTC_SHAPE_PYRAMID:
+    {
+        const LtcConfigPyramid *pyramid = (const LtcConfigPyramid *)config;
+        if(pyramid->m_numFacets < 3 || pyramid->m_divPerFacetRadial < 1 || pyramid->m_divAxial < 1 || pyramid->m_divRings < 1 ||
+           !(pyramid->m_radius > 0.0f) || !(pyramid->m_length > 0.0f))
+            return LTC_ERR_INVALIDARGS;
+        uint32_t divCap = (uint32_t)pyramid->m_numFacets * pyramid->m_divPerFacetRadial;
+        ltcAddPatch(layout, config, ltcEvalPyramidFacet, pyramid->m_divPerFacetRadial, pyramid->m_divAxial, pyramid->m_numFacets, LTC_PATCH_COLLAPSE_V1, 1.0f);
+        ltcAddPatch(layout, config, ltcEvalPyramidCap, divCap, pyramid->m_divRings, 1, LTC_PATCH_COLLAPSE_V1 | LTC_PATCH_FLIP, -1.0f);
+        break;
+    }
+    case LTC_SHAPE_TUBE:
+    {
+        const LtcConfigTube *tube = (const LtcConfigTube *)config;
+        if(tube->m_divRadial < 3 || tube->m_divAxial < 1 || tube->m_divRings < 1 || !(tube->m_length > 0.0f) ||
+           !(tube->m_innerRadius > 0.0f) || !(tube->m_outerRadius > tube->m_innerRadius))
+            return LTC_ERR_INVALIDARGS;
+        ltcAddPatch(layout, config, ltcEvalTubeWall, tube->m_divRadial, tube->m_divAxial, 1, 0, 1.0f);
+        ltcAddPatch(layout, config, ltcEvalTubeWall, tube->m_divRadial, tube->m_divAxial, 1, LTC_PATCH_FLIP, -1.0f);
+        ltcAddPatch(layout, config, ltcEvalTubeCap, tube->m_divRadial, tube->m_divRings, 1, 0, 1.0f);
+        ltcAddPatch(layout, config, ltcEvalTubeCap, tube->m_divRadial, tube->m_divRings, 1, LTC_PATCH_FLIP, -1.0f);
+        break;
+    }
+    case LTC_SHAPE_CAPSULE:
+    {
+        const LtcConfigCapsule *capsule = (const LtcConfigCapsule *)config;
+        if(capsule->m_divRadial < 3 || capsule->m_divAxial < 1 || capsule->m_divLatitude < 1 ||
+           !(capsule->m_radius > 0.0f) || !(capsule->m_cylinderLength >= 0.0f))
+            return LTC_ERR_INVALIDARGS;
+        ltcAddPatch(layout, config, ltcEvalCapsuleCap, capsule->m_divRadial, capsule->m_divLatitude, 1, LTC_PATCH_COLLAPSE_V0, LTC_PI);
+        ltcAddPatch(layout, config, ltcEvalCapsuleWall, capsule->m_divRadial, capsule->m_divAxial, 1, 0, 1.0f);
+        ltcAddPatch(layout, config, ltcEvalCapsuleCap, capsule->m_divRadial, capsule->m_divLatitude, 1, LTC_PATCH_COLLAPSE_V1, LTC_PI * 0.5f);
+        break;
+    }
+    case LTC_SHAPE_TORUS:
+    {
+        const LtcConfigTorus *torus = (const LtcConfigTorus *)config;
+        if(torus->m_divRadialMinor < 3 || torus->m_divRadialMajor < 3 ||
+           !(torus->m_minorRadius > 0.0f) || !(torus->m_majorRadius > 0.0f))
+            return LTC_ERR_INVALIDARGS;
+        ltcAddPatch(layout, config, ltcEvalTorus, torus->m_divRadialMajor, torus->m_divRadialMinor, 1, 0, 0.0f);
+        break;
+    }
+    case LTC_SHAPE_TORUSKNOT:
+    {
+        const LtcConfigTorusKnot *knot = (const LtcConfigTorusKnot *)config;
+        if(knot->m_divRadial < 3 || knot->m_divTubular < 3 || knot->m_p == 0 || knot->m_q == 0 ||
+           !(knot->m_radius > 0.0f) || !(knot->m_torusRadius >= 0.0f) || !(knot->m_tubeRadius > 0.0f))
+            return LTC_ERR_INVALIDARGS;
+        ltcAddPatch(layout, config, ltcEvalTorusKnot, knot->m_divTubular, knot->m_divRadial, 1, 0, 0.0f);
+        break;
+    }
+    default:
+        return LTC_ERR_INVALIDARGS;
+    }
+
+    return LTC_OK;
+}
+
+/* Indices of one quad row as a strip: both vertex rows, a repeated first
+ * vertex for the flipped winding and the restart index. */
+static uint32_t ltcStripRowIndexCount(const LtcPatch *patch)
+{
+    return 2 * (patch->m_divU + 1) + (ltcPatchFlipWinding(patch) ? 1 : 0) + 1;
+}
+
+uint32_t ltcPatchVertexCount(const LtcPatch *patch)
+{
+    return (patch->m_divU + 1) * (patch->m_divV + 1);
+}
+
+uint32_t ltcPatchIndexCount(const LtcPatch *patch)
+{
+    if(patch->m_config->m_indexTopology == LTC_INDEX_TOPOLOGY_TRIANGLE_STRIP)
+        return patch->m_divV * ltcStripRowIndexCount(patch);
+    uint32_t collapsed = ((patch->m_flags & LTC_PATCH_COLLAPSE_V0) ? 1 : 0) +
+                         ((patch->m_flags & LTC_PATCH_COLLAPSE_V1) ? 1 : 0);
+    return 3 * patch->m_divU * (2 * patch->m_divV - collapsed);
+}
+
+LtcError_t ltcLayoutSize(const LtcLayout *layout, LtcGeometrySize *outSize)
+{
+    uint64_t numVertices = 0;
+    uint64_t numIndices  = 0;
+    for(uint32_t p = 0; p < layout->m_numPatches; ++p)
+    {
+        const LtcPatch *patch = &layout->m_patches[p];
+        numVertices += (uint64_t)patch->m_count * ltcPatchVertexCount(patch);
+        numIndices  += (uint64_t)patch->m_count * ltcPatchIndexCount(patch);
+    }
+
+    if(numVertices > UINT32_MAX || numIndices > UINT32_MAX)
+        return LTC_ERR_INVALIDARGS;
+
+    outSize->m_numVertices = (uint32_t)numVertices;
+    outSize->m_numIndices  = (uint32_t)numIndices;
+    return LTC_OK;
+}
+
+LtcError_t ltcQueryGeometrySize(const LtcConfig *config, LtcGeometrySize *outSize)
+{
+    if(!config || !outSize)
+        return LTC_ERR_INVALIDARGS;
+
+    LtcLayout layout;
+    LtcError_t err = ltcBuildLayout(config, &layout);
+    if(err != LTC_OK)
+        return err;
+
+    return ltcLayoutSize(&layout, outSize);
+}
+
+/* ---- bounds ------------------------------------------------------------ */
+
+/* Box of half extents (x, y, z) around the origin and the sphere through its
+ * corners. */
+static void ltcSetBox(LtcBounds *bounds, float x, float y, float z)
+{
+    ltcSet3(bounds->m_min, -x, -y, -z);
+    ltcSet3(bounds->m_max, x, y, z);
+    ltcSet3(bounds->m_center, 0.0f, 0.0f, 0.0f);
+    bounds->m_radius = sqrtf(x * x + y * y + z * z);
+}
+
+/* Box of a regular polygon around the Y axis, from its corners. */
+static void ltcSetPolygonBox(LtcBounds *bounds, uint32_t numSides, float radius, float halfLength)
+{
+    ltcSetBox(bounds, 0.0f, halfLength, 0.0f);
+    for(uint32_t k = 0; k < numSides; ++k)
+    {
+        float corner[3];
+        ltcPolygonCorner(k, numSides, radius, corner);
+        bounds->m_min[0] = corner[0] < bounds->m_min[0] ? corner[0] : bounds->m_min[0];
+        bounds->m_max[0] = corner[0] > bounds->m_max[0] ? corner[0] : bounds->m_max[0];
+        bounds->m_min[2] = corner[2] < bounds->m_min[2] ? corner[2] : bounds->m_min[2];
+        bounds->m_max[2] = corner[2] > bounds->m_max[2] ? corner[2] : bounds->m_max[2];
+    }
+}
+
+/* Smallest sphere around a base circle of the given radius at -halfLength
+ * and an apex at +halfLength, centred on the axis. */
+static void ltcSetApexSphere(LtcBounds *bounds, float radius, float halfLength)
+{
+    if(radius >= 2.0f * halfLength)
+    {
+        ltcSet3(bounds->m_center, 0.0f, -halfLength, 0.0f);
+        bounds->m_radius = radius;
+        return;
+    }
+    float offset = radius * radius / (4.0f * halfLength);
+    ltcSet3(bounds->m_center, 0.0f, -offset, 0.0f);
+    bounds->m_radius = halfLength + offset;
+}
+
+#define LTC_BOUNDS_PADDING (1.0f / (1 << 20))
+
+LtcError_t ltcQueryGeometryBounds(const LtcConfig *config, LtcBounds *outBounds)
+{
+    if(!config || !outBounds)
+        return LTC_ERR_INVALIDARGS;
+
+    LtcLayout layout;
+    LtcError_t err = ltcBuildLayout(config, &layout);
+    if(err != LTC_OK)
+        return err;
+
+    /* every shape is centred on the origin, round ones around the Y axis */
+    switch(config->m_shape)
+    {
+    case LTC_SHAPE_PLANE:
+    {
+        const LtcConfigPlane *plane = (const LtcConfigPlane *)config;
+        ltcSetBox(outBounds, plane->m_sizeX * 0.5f, plane->m_sizeY * 0.5f, 0.0f);
+        break;
+    }
+    case LTC_SHAPE_CUBOID:
+    {
+        const LtcConfigCuboid *cuboid = (const LtcConfigCuboid *)config;
+        ltcSetBox(outBounds, cuboid->m_sizeX * 0.5f, cuboid->m_sizeY * 0.5f, cuboid->m_sizeZ * 0.5f);
+        break;
+    }
+    case LTC_SHAPE_SPHERE:
+    {
+        const LtcConfigSphere *sphere = (const LtcConfigSphere *)config;
+        ltcSetBox(outBounds, sphere->m_radius, sphere->m_radius, sphere->m_radius);
+        outBounds->m_radius = sphere->m_radius;
+        break;
+    }
+    case LTC_SHAPE_CYLINDER:
+    {
+        const LtcConfigCylinder *cylinder = (const LtcConfigCylinder *)config;
+        ltcSetBox(outBounds, cylinder->m_radius, cylinder->m_length * 0.5f, cylinder->m_radius);
+        outBounds->m_radius = sqrtf(cylinder->m_radius * cylinder->m_radius + cylinder->m_length * cylinder->m_length * 0.25f);
+        break;
+    }
+    case LTC_SHAPE_CONE:
+    {
+        const LtcConfigCone *cone = (const LtcConfigCone *)config;
+        ltcSetBox(outBounds, cone->m_radius, cone->m_length * 0.5f, cone->m_radius);
+        ltcSetApexSphere(outBounds, cone->m_radius, cone->m_length * 0.5f);
+        break;
+    }
+    case LTC_SHAPE_PRISM:
+    {
+        const LtcConfigPrism *prism = (const LtcConfigPrism *)config;
+        ltcSetPolygonBox(outBounds, prism->m_numFacets, prism->m_radius, prism->m_length * 0.5f);
+        outBounds->m_radius = sqrtf(prism->m_radius * prism->m_radius + prism->m_length * prism->m_length * 0.25f);
+        break;
+    }
+    case LTC_SHAPE_PYRAMID:
+    {
+        const LtcConfigPyramid *pyramid = (const LtcConfigPyramid *)config;
+        ltcSetPolygonBox(outBounds, pyramid->m_numFacets, pyramid->m_radius, pyramid->m_length * 0.5f);
+        ltcSetApexSphere(outBounds, pyramid->m_radius, pyramid->m_length * 0.5f);
+        break;
+    }
+    case LTC_SHAPE_TUBE:
+    {
+        const LtcConfigTube *tube = (const LtcConfigTube *)config;
+        ltcSetBox(outBounds, tube->m_outerRadius, tube->m_length * 0.5f, tube->m_outerRadius);
+        outBounds->m_radius = sqrtf(tube->m_outerRadius * tube->m_outerRadius + tube->m_length * tube->m_length * 0.25f);
+        break;
+    }
+    case LTC_SHAPE_CAPSULE:
+    {
+        const LtcConfigCapsule *capsule = (const LtcConfigCapsule *)config;
+        float halfLength = capsule->m_cylinderLength * 0.5f;
+        ltcSetBox(outBounds, capsule->m_radius, halfLength + capsule->m_radius, capsule->m_radius);
+        outBounds->m_radius = halfLength + capsule->m_radius;
+        break;
+    }
+    case LTC_SHAPE_TORUS:
+    {
+        const LtcConfigTorus *torus = (const LtcConfigTorus *)config;
+        float outer = torus->m_majorRadius + torus->m_minorRadius;
+        ltcSetBox(outBounds, outer, torus->m_minorRadius, outer);
+        outBounds->m_radius = outer;
+        break;
+    }
+    case LTC_SHAPE_TORUSKNOT:
+    {
+        /* the centre line stays on a torus of radii (m_radius, m_torusRadius) */
+        const LtcConfigTorusKnot *knot = (const LtcConfigTorusKnot *)config;
+        float outer = knot->m_radius + knot->m_torusRadius + knot->m_tubeRadius;
+        ltcSetBox(outBounds, outer, knot->m_torusRadius + knot->m_tubeRadius, outer);
+        outBounds->m_radius = outer;
+        break;
+    }
+    default:
+        return LTC_ERR_INVALIDARGS;
+    }
+
+    /* generated positions can land an ulp or so outside the exact shape */
+    float pad = outBounds->m_radius * LTC_BOUNDS_PADDING;
+    for(int c = 0; c < 3; ++c)
+    {
+        outBounds->m_min[c] -= pad;
+        outBounds->m_max[c] += pad;
+    }
+    outBounds->m_radius += pad;
+    return LTC_OK;
+}
+
+static uint32_t ltcGetNumComponents(LtcVertexAttribSize_t attribSize)
+{
+    switch(attribSize)
+    {
+    case LTC_VERTEX_ATTRIB_SIZE_FLOAT:  return 1;
+    case LTC_VERTEX_ATTRIB_SIZE_FLOAT2: return 2;
+    case LTC_VERTEX_ATTRIB_SIZE_FLOAT3: return 3;
+    case LTC_VERTEX_ATTRIB_SIZE_FLOAT4: return 4;
+    default:                            return 0;
+    }
+}
+
+static uint32_t ltcGetFormatComponentSize(LtcVertexAttribFormat_t format)
+{
+    switch(format)
+    {
+    case LTC_VERTEX_ATTRIB_FORMAT_FLOAT:            return 4;
+    case LTC_VERTEX_ATTRIB_FORMAT_HALF:             return 2;
+    case LTC_VERTEX_ATTRIB_FORMAT_SNORM16:          return 2;
+    case LTC_VERTEX_ATTRIB_FORMAT_UNORM16:          return 2;
+    case LTC_VERTEX_ATTRIB_FORMAT_SNORM_10_10_10_2: return 4;
+    case LTC_VERTEX_ATTRIB_FORMAT_OCT_SNORM16:      return 4;
+    case LTC_VERTEX_ATTRIB_FORMAT_OCT_SNORM8:       return 2;
+    default:                                        return 0;
+    }
+}
+
+/* Stored components per vertex, 0 for an invalid combination. */
+static uint32_t ltcGetStoredComponents(LtcVertexAttribType_t attribType, LtcVertexAttribSize_t attribSize,
+                                       LtcVertexAttribFormat_t format)
+{
+    uint32_t numComponents = ltcGetNumComponents(attribSize);
+    if(ltcGetFormatComponentSize(format) == 0)
+        return 0;
+    if(attribType == LTC_VERTEX_ATTRIB_TYPE_QTANGENT)
+        return numComponents == 4 && (format == LTC_VERTEX_ATTRIB_FORMAT_FLOAT || format == LTC_VERTEX_ATTRIB_FORMAT_HALF ||
+                                      format == LTC_VERTEX_ATTRIB_FORMAT_SNORM16) ? 4 : 0;
+
+    switch(format)
+    {
+    case LTC_VERTEX_ATTRIB_FORMAT_SNORM_10_10_10_2:
+        return numComponents >= 3 ? 1 : 0;
+    case LTC_VERTEX_ATTRIB_FORMAT_OCT_SNORM16:
+    case LTC_VERTEX_ATTRIB_FORMAT_OCT_SNORM8:
+        return numComponents == 3 && (attribType == LTC_VERTEX_ATTRIB_TYPE_NORMAL || attribType == LTC_VERTEX_ATTRIB_TYPE_TANGENT ||
+                                      attribType == LTC_VERTEX_ATTRIB_TYPE_BITANGENT) ? 1 : 0;
+    default:
+        return numComponents;
+    }
+}
+
+static uint32_t ltcGetElementSize(const LtcVertexAttribBuffer *attribBuffer)
+{
+    return ltcGetStoredComponents(attribBuffer->m_attribType, attribBuffer->m_attribSize, attribBuffer->m_format) *
+           ltcGetFormatComponentSize(attribBuffer->m_format);
+}
+
+/* Components in separate streams rather than adjacent in each vertex. */
+static int ltcIsStreamed(const LtcVertexAttribBuffer *attribBuffer)
+{
+    return attribBuffer->m_componentStride > ltcGetFormatComponentSize(attribBuffer->m_format);
+}
+
+static uint32_t ltcGetComponentStride(const LtcVertexAttribBuffer *attribBuffer)
+{
+    return attribBuffer->m_componentStride ? attribBuffer->m_componentStride : ltcGetFormatComponentSize(attribBuffer->m_format);
+}
+
+static uint32_t ltcGetStride(const LtcVertexAttribBuffer *attribBuffer)
+{
+    if(attribBuffer->m_stride)
+        return attribBuffer->m_stride;
+    return ltcIsStreamed(attribBuffer) ? ltcGetFormatComponentSize(attribBuffer->m_format) : ltcGetElementSize(attribBuffer);
+}
+
+size_t ltcGetVertexAttribBufferSize(const LtcVertexAttribBuffer *attribBuffer, uint32_t numVertices)
+{
+    if(!attribBuffer || numVertices == 0 || ltcGetElementSize(attribBuffer) == 0)
+        return 0;
+
+    uint32_t numStored = ltcGetStoredComponents(attribBuffer->m_attribType, attribBuffer->m_attribSize, attribBuffer->m_format);
+    size_t last = (size_t)(numStored - 1) * ltcGetComponentStride(attribBuffer);
+    size_t stream = (size_t)(numVertices - 1) * ltcGetStride(attribBuffer) + ltcGetFormatComponentSize(attribBuffer->m_format);
+    if(ltcIsStreamed(attribBuffer) && stream < attribBuffer->m_componentStride)
+        stream = attribBuffer->m_componentStride;
+    return last + stream;
+}
+
+size_t ltcGetIndexBufferSize(LtcIndexSize_t indexSize, uint32_t numIndices)
+{
+    if(indexSize == LTC_INDEX_SIZE_AUTO)
+        indexSize = LTC_INDEX_SIZE_32;
+    return (size_t)numIndices * (size_t)indexSize;
+}
+
+LtcIndexSize_t ltcGetIndexSizeForVertices(uint32_t numVertices)
+{
+    if(numVertices <= 0xFFu + 1)
+        return LTC_INDEX_SIZE_8;
+    if(numVertices <= 0xFFFFu + 1)
+        return LTC_INDEX_SIZE_16;
+    return LTC_INDEX_SIZE_32;
+}
+
+uint32_t ltcGetPrimitiveRestartIndex(LtcIndexSize_t indexSize)
+{
+    switch(indexSize)
+    {
+    case LTC_INDEX_SIZE_8:
+        return 0xFFu;
+    case LTC_INDEX_SIZE_16:
+        return 0xFFFFu;
+    default:
+        return 0xFFFFFFFFu;
+    }
+}
+
+uint32_t ltcIndexRange(LtcIndexTopology_t topology, uint32_t numVertices)
+{
+    if(topology == LTC_INDEX_TOPOLOGY_TRIANGLE_STRIP && numVertices < UINT32_MAX)
+        return numVertices + 1;
+    return numVertices;
+}
+
+void ltcInitVertexLayout(LtcVertexLayout *layout)
+{
+    layout->m_numElements = 0;
+    layout->m_stride      = 0;
+}
+
+static uint32_t ltcAlignUp(uint32_t value, uint32_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+LtcError_t ltcAddVertexElement(LtcVertexLayout *layout, LtcVertexAttribType_t attribType, LtcVertexAttribSize_t attribSize)
+{
+    return ltcAddVertexElementFormat(layout, attribType, attribSize, LTC_VERTEX_ATTRIB_FORMAT_FLOAT);
+}
+
+LtcError_t ltcAddVertexElementFormat(LtcVertexLayout *layout, LtcVertexAttribType_t attribType,
+                                     LtcVertexAttribSize_t attribSize, LtcVertexAttribFormat_t format)
+{
+    if(!layout || layout->m_numElements >= LTC_VERTEX_ATTRIB_COUNT ||
+       ltcGetVertexAttribSlot(attribType) < 0 || ltcGetStoredComponents(attribType, attribSize, format) == 0)
+        return LTC_ERR_INVALIDARGS;
+
+    uint32_t componentSize = ltcGetFormatComponentSize(format);
+    uint32_t alignment = componentSize;
+    for(uint32_t e = 0; e < layout->m_numElements; ++e)
+    {
+        uint32_t other = ltcGetFormatComponentSize(layout->m_elements[e].m_format);
+        alignment = other > alignment ? other : alignment;
+    }
+
+    LtcVertexElement *element = &layout->m_elements[layout->m_numElements++];
+    element->m_attribType = attribType;
+    element->m_attribSize = attribSize;
+    element->m_format     = format;
+    element->m_offset     = ltcAlignUp(layout->m_stride, componentSize);
+    layout->m_stride      = ltcAlignUp(element->m_offset + ltcGetStoredComponents(attribType, attribSize, format) * componentSize, alignment);
+    return LTC_OK;
+}
+
+static uint32_t ltcGetVertexElementSize(const LtcVertexElement *element)
+{
+    return ltcGetStoredComponents(element->m_attribType, element->m_attribSize, element->m_format) * ltcGetFormatComponentSize(element->m_format);
+}
+
+static LtcError_t ltcValidateVertexLayout(const LtcVertexLayout *layout)
+{
+    if(layout->m_numElements > LTC_VERTEX_ATTRIB_COUNT)
+        return LTC_ERR_INVALIDARGS;
+
+    uint32_t types = 0;
+    for(uint32_t e = 0; e < layout->m_numElements; ++e)
+    {
+        const LtcVertexElement *element = &layout->m_elements[e];
+        uint32_t size = ltcGetVertexElementSize(element);
+        if(ltcGetVertexAttribSlot(element->m_attribType) < 0 || size == 0 ||
+           (types & (uint32_t)element->m_attribType) ||
+           element->m_offset % ltcGetFormatComponentSize(element->m_format) || element->m_offset + size > layout->m_stride)
+            return LTC_ERR_INVALIDARGS;
+        types |= (uint32_t)element->m_attribType;
+
+        for(uint32_t other = 0; other < e; ++other)
+        {
+            const LtcVertexElement *prev = &layout->m_elements[other];
+            uint32_t prevSize = ltcGetVertexElementSize(prev);
+            if(element->m_offset < prev->m_offset + prevSize && prev->m_offset < element->m_offset + size)
+                return LTC_ERR_INVALIDARGS;
+        }
+    }
+    return LTC_OK;
+}
+
+size_t ltcGetVertexLayoutBufferSize(const LtcVertexLayout *layout, uint32_t numVertices)
+{
+    if(!layout)
+        return 0;
+    return (size_t)numVertices * layout->m_stride;
+}
+
+LtcError_t ltcSetVertexLayout(LtcGeometry *geometry, const LtcVertexLayout *layout, void *buffer)
+{
+    if(!geometry || !layout || !buffer || ltcValidateVertexLayout(layout) != LTC_OK)
+        return LTC_ERR_INVALIDARGS;
+
+    for(uint32_t e = 0; e < layout->m_numElements; ++e)
+    {
+        const LtcVertexElement *element = &layout->m_elements[e];
+        if(geometry->m_vertexAttribMask & (uint32_t)element->m_attribType)
+            ltcRemoveVertexAttribBuffer(geometry, element->m_attribType);
+
+        LtcVertexAttribBuffer attrib;
+        attrib.m_buffer          = (uint8_t *)buffer + element->m_offset;
+        attrib.m_stride          = layout->m_stride;
+        attrib.m_attribType      = element->m_attribType;
+        attrib.m_attribSize      = element->m_attribSize;
+        attrib.m_componentStride = 0;
+        attrib.m_format          = element->m_format;
+        ltcAddVertexAttribBuffer(geometry, &attrib);
+    }
+    return LTC_OK;
+}
+
+static size_t ltcGetStreamSize(uint32_t numVertices, uint32_t componentSize, uint32_t alignment)
+{
+    if(alignment < sizeof(float) || (alignment & (alignment - 1)))
+        return 0;
+    size_t size = (size_t)numVertices * componentSize;
+    return (size + alignment - 1) & ~(size_t)(alignment - 1);
+}
+
+size_t ltcGetVertexStreamSize(uint32_t numVertices, uint32_t alignment)
+{
+    return ltcGetStreamSize(numVertices, (uint32_t)sizeof(float), alignment);
+}
+
+size_t ltcGetVertexStreamsBufferSize(const LtcVertexLayout *layout, uint32_t numVertices, uint32_t alignment)
+{
+    if(!layout)
+        return 0;
+
+    size_t size = 0;
+    for(uint32_t e = 0; e < layout->m_numElements && e < LTC_VERTEX_ATTRIB_COUNT; ++e)
+    {
+        const LtcVertexElement *element = &layout->m_elements[e];
+        size += ltcGetStoredComponents(element->m_attribType, element->m_attribSize, element->m_format) *
+                ltcGetStreamSize(numVertices, ltcGetFormatComponentSize(element->m_format), alignment);
+    }
+    return size;
+}
+
+LtcError_t ltcSetVertexStreams(LtcGeometry *geometry, const LtcVertexLayout *layout, uint32_t numVertices,
+                               uint32_t alignment, void *buffer)
+{
+    size_t maxStreamSize = ltcGetVertexStreamSize(numVertices, alignment);
+    if(!geometry || !layout || !buffer || numVertices == 0 || maxStreamSize == 0 || maxStreamSize > UINT32_MAX ||
+       ((uintptr_t)buffer & (alignment - 1)) || layout->m_numElements > LTC_VERTEX_ATTRIB_COUNT)
+        return LTC_ERR_INVALIDARGS;
+
+    uint32_t types = 0;
+    for(uint32_t e = 0; e < layout->m_numElements; ++e)
+    {
+        const LtcVertexElement *element = &layout->m_elements[e];
+        if(ltcGetVertexAttribSlot(element->m_attribType) < 0 ||
+           ltcGetStoredComponents(element->m_attribType, element->m_attribSize, element->m_format) == 0 ||
+           (types & (uint32_t)element->m_attribType))
+            return LTC_ERR_INVALIDARGS;
+        types |= (uint32_t)element->m_attribType;
+    }
+
+    uint8_t *stream = (uint8_t *)buffer;
+    for(uint32_t e = 0; e < layout->m_numElements; ++e)
+    {
+        const LtcVertexElement *element = &layout->m_elements[e];
+        if(geometry->m_vertexAttribMask & (uint32_t)element->m_attribType)
+            ltcRemoveVertexAttribBuffer(geometry, element->m_attribType);
+
+        uint32_t componentSize = ltcGetFormatComponentSize(element->m_format);
+        size_t streamSize = ltcGetStreamSize(numVertices, componentSize, alignment);
+
+        LtcVertexAttribBuffer attrib;
+        attrib.m_buffer          = stream;
+        attrib.m_stride          = componentSize;
+        attrib.m_attribType      = element->m_attribType;
+        attrib.m_attribSize      = element->m_attribSize;
+        attrib.m_componentStride = (uint32_t)streamSize;
+        attrib.m_format          = element->m_format;
+        ltcAddVertexAttribBuffer(geometry, &attrib);
+
+        stream += streamSize * ltcGetStoredComponents(element->m_attribType, element->m_attribSize, element->m_format);
+    }
+    return LTC_OK;
+}
+
+/* ---- generation -------------------------------------------------------- */
+
+LtcError_t ltcValidateBuffers(const LtcGeometry *geometry, uint32_t numVertices)
+{
+    if(geometry->m_vertexAttribMask & ~((1u << LTC_VERTEX_ATTRIB_COUNT) - 1))
+        return LTC_ERR_INVALIDARGS;
+
+    for(uint32_t slot = 0; slot < LTC_VERTEX_ATTRIB_COUNT; ++slot)
+    {
+        const LtcVertexAttribBuffer *attrib = &geometry->m_vertexAttribs[slot];
+        if(!(geometry->m_vertexAttribMask & (1u << slot)))
+            continue;
+        if((uint32_t)attrib->m_attribType != (1u << slot) || ltcGetElementSize(attrib) == 0)
+            return LTC_ERR_INVALIDARGS;
+        uint32_t componentSize = ltcGetFormatComponentSize(attrib->m_format);
+        if(attrib->m_componentStride % componentSize)
+            return LTC_ERR_INVALIDARGS;
+        if(ltcIsStreamed(attrib))
+        {
+            /* streams must not run into each other */
+            if(attrib->m_stride % componentSize ||
+               (uint64_t)(numVertices ? numVertices - 1 : 0) * ltcGetStride(attrib) + componentSize > attrib->m_componentStride)
+                return LTC_ERR_INVALIDARGS;
+        }
+        else if(attrib->m_stride && attrib->m_stride < ltcGetElementSize(attrib))
+            return LTC_ERR_INVALIDARGS;
+    }
+
+    const LtcIndexBuffer *indices = geometry->m_indices;
+    if(indices)
+    {
+        switch(indices->m_indexSize)
+        {
+        case LTC_INDEX_SIZE_8:
+            if(numVertices > 0xFFu + 1)
+                return LTC_ERR_INVALIDARGS;
+            break;
+        case LTC_INDEX_SIZE_16:
+            if(numVertices > 0xFFFFu + 1)
+                return LTC_ERR_INVALIDARGS;
+            break;
+        case LTC_INDEX_SIZE_32:
+        case LTC_INDEX_SIZE_AUTO:
+            break;
+        default:
+            return LTC_ERR_INVALIDARGS;
+        }
+    }
+
+    return LTC_OK;
+}
+
+void ltcResolveIndexSize(LtcGeometry *geometry, uint32_t numVertices)
+{
+    if(!geometry->m_indices)
+        geometry->m_indexSize = LTC_INDEX_SIZE_NONE;
+    else if(geometry->m_indices->m_indexSize == LTC_INDEX_SIZE_AUTO)
+        geometry->m_indexSize = ltcGetIndexSizeForVertices(numVertices);
+    else
+        geometry->m_indexSize = geometry->m_indices->m_indexSize;
+}
+
+const LtcIndexBuffer *ltcGetWrittenIndices(const LtcGeometry *geometry, LtcIndexBuffer *scratch)
+{
+    if(!geometry->m_indices)
+        return NULL;
+    scratch->m_buffer    = geometry->m_indices->m_buffer;
+    scratch->m_indexSize = geometry->m_indexSize;
+    return scratch;
+}
+
+/* Allocates payloads attached as NULL and resizes the ones lattica owns. */
+static LtcError_t ltcAllocateBuffer(LtcGeometry *geometry, void **buffer, uint32_t bit, size_t size)
+{
+    const LtcAllocator *allocator = &geometry->m_allocator;
+    void *ptr;
+    if(geometry->m_allocatedBuffers & bit)
+        ptr = allocator->m_realloc(*buffer, size ? size : 1, allocator->m_userData);
+    else if(!*buffer)
+        ptr = allocator->m_alloc(size ? size : 1, allocator->m_userData);
+    else
+        return LTC_OK;
+
+    if(!ptr)
+        return LTC_ERR_OUTOFMEMORY;
+
+    *buffer = ptr;
+    geometry->m_allocatedBuffers |= bit;
+    return LTC_OK;
+}
+
+LtcError_t ltcAllocateBuffers(const LtcAllocator *allocator, LtcGeometry *geometry, const LtcGeometrySize *size)
+{
+    if(!geometry->m_allocatedBuffers)
+        geometry->m_allocator = *allocator;
+    memset(geometry->m_topology, 0, sizeof(geometry->m_topology));
+
+    for(uint32_t slot = 0; slot < LTC_VERTEX_ATTRIB_COUNT; ++slot)
+    {
+        LtcVertexAttribBuffer *attrib = &geometry->m_vertexAttribs[slot];
+        if(!(geometry->m_vertexAttribMask & (1u << slot)))
+            continue;
+
+        LtcError_t err = ltcAllocateBuffer(geometry, &attrib->m_buffer, 1u << slot,
+                                           ltcGetVertexAttribBufferSize(attrib, size->m_numVertices));
+        if(err != LTC_OK)
+            return err;
+    }
+
+    if(geometry->m_indices)
+    {
+        LtcIndexBuffer *indices = geometry->m_indices;
+        return ltcAllocateBuffer(geometry, &indices->m_buffer, LTC_ALLOCATED_INDEX_BUFFER,
+                                 ltcGetIndexBufferSize(geometry->m_indexSize, size->m_numIndices));
+    }
+
+    return LTC_OK;
+}
+
+void ltcInitVertexWriter(const LtcGeometry *geometry, LtcVertexWriter *writer)
+{
+    writer->m_numOutputs = 0;
+    for(uint32_t slot = 0; slot < LTC_VERTEX_ATTRIB_COUNT; ++slot)
+    {
+        const LtcVertexAttribBuffer *attrib = &geometry->m_vertexAttribs[slot];
+        if(!(geometry->m_vertexAttribMask & (1u << slot)))
+            continue;
+
+        LtcAttribOutput *output = &writer->m_outputs[writer->m_numOutputs++];
+        output->m_buffer        = (uint8_t *)attrib->m_buffer;
+        output->m_stride          = ltcGetStride(attrib);
+        output->m_componentStride = ltcGetComponentStride(attrib);
+        output->m_slot            = slot;
+        output->m_numComponents   = ltcGetNumComponents(attrib->m_attribSize);
+        output->m_numStored       = ltcGetStoredComponents(attrib->m_attribType, attrib->m_attribSize, attrib->m_format);
+        output->m_componentSize   = ltcGetFormatComponentSize(attrib->m_format);
+        output->m_format          = attrib->m_format;
+        output->m_streamed        = ltcIsStreamed(attrib);
+    }
+}
+
+/* Slot of LTC_VERTEX_ATTRIB_TYPE_QTANGENT; its values are derived from the
+ * normal and tangent slots rather than produced by the shapes. */
+#define LTC_QTANGENT_SLOT 5
+
+/* Round to nearest even, overflow to infinity, NaN stays NaN. */
+static uint16_t ltcFloatToHalf(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = (bits >> 16) & 0x8000u;
+    bits &= 0x7FFFFFFFu;
+
+    if(bits >= 0x7F800000u)
+        return (uint16_t)(sign | 0x7C00u | (bits > 0x7F800000u ? 0x200u : 0));
+    if(bits >= 0x477FF000u)
+        return (uint16_t)(sign | 0x7C00u);
+    if(bits < 0x38800000u)
+    {
+        /* subnormal: adding 0.5 lines the half ulp up with the float ulp and
+         * lets the FPU do the rounding */
+        float magnitude;
+        memcpy(&magnitude, &bits, sizeof(bits));
+        magnitude += 0.5f;
+        memcpy(&bits, &magnitude, sizeof(bits));
+        return (uint16_t)(sign | (bits - 0x3F000000u));
+    }
+
+    /* rebias the exponent from 127 to 15 and round on the dropped bits */
+    bits += 0xC8000FFFu + ((bits >> 13) & 1);
+    return (uint16_t)(sign | (bits >> 13));
+}
+
+static int32_t ltcQuantizeSnorm(float value, float scale)
+{
+    value = value > 1.0f ? 1.0f : (value >= -1.0f ? value : -1.0f);
+    value *= scale;
+    return (int32_t)(value + (value >= 0.0f ? 0.5f : -0.5f));
+}
+
+static uint32_t ltcQuantizeUnorm(float value, float scale)
+{
+    value = value > 1.0f ? 1.0f : (value >= 0.0f ? value : 0.0f);
+    return (uint32_t)(value * scale + 0.5f);
+}
+
+/* Folds a direction onto the octahedron, giving a point in [-1, 1]^2. */
+static void ltcOctEncode(const float *v, float *out)
+{
+    float l1 = fabsf(v[0]) + fabsf(v[1]) + fabsf(v[2]);
+    float x = l1 > 0.0f ? v[0] / l1 : 0.0f;
+    float y = l1 > 0.0f ? v[1] / l1 : 0.0f;
+    if(v[2] < 0.0f)
+    {
+        float fx = (1.0f - fabsf(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        float fy = (1.0f - fabsf(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = fx;
+        y = fy;
+    }
+    out[0] = x;
+    out[1] = y;
+}
+
+/* Quaternion of the frame (tangent, normal x tangent, normal); tangent[3] is
+ * the handedness. w stays clear of zero so its sign survives snorm16, and is
+ * negative for mirrored frames. */
+static void ltcQTangent(const float *normal, const float *tangent, float *out)
+{
+    float b[3], t[3];
+    ltcCross(normal, tangent, b);
+    ltcNormalize(b);
+    ltcCross(b, normal, t);
+
+    /* columns t, b, normal */
+    float m00 = t[0], m01 = b[0], m02 = normal[0];
+    float m10 = t[1], m11 = b[1], m12 = normal[1];
+    float m20 = t[2], m21 = b[2], m22 = normal[2];
+    float trace = m00 + m11 + m22;
+    float x, y, z, w;
+    if(trace > 0.0f)
+    {
+        float r = 0.5f / sqrtf(trace + 1.0f);
+        w = 0.25f / r;
+        x = (m21 - m12) * r;
+        y = (m02 - m20) * r;
+        z = (m10 - m01) * r;
+    }
+    else if(m00 > m11 && m00 > m22)
+    {
+        float r = 2.0f * sqrtf(1.0f + m00 - m11 - m22);
+        w = (m21 - m12) / r;
+        x = 0.25f * r;
+        y = (m01 + m10) / r;
+        z = (m02 + m20) / r;
+    }
+    else if(m11 > m22)
+    {
+        float r = 2.0f * sqrtf(1.0f + m11 - m00 - m22);
+        w = (m02 - m20) / r;
+        x = (m01 + m10) / r;
+        y = 0.25f * r;
+        z = (m12 + m21) / r;
+    }
+    else
+    {
+        float r = 2.0f * sqrtf(1.0f + m22 - m00 - m11);
+        w = (m10 - m01) / r;
+        x = (m02 + m20) / r;
+        y = (m12 + m21) / r;
+        z = 0.25f * r;
+    }
+
+    float len = sqrtf(x * x + y * y + z * z + w * w);
+    float scale = (w < 0.0f ? -1.0f : 1.0f) / len;
+    x *= scale;
+    y *= scale;
+    z *= scale;
+    w *= scale;
+
+    const float bias = 1.0f / 32767.0f;
+    if(w < bias)
+    {
+        float xyz = sqrtf(x * x + y * y + z * z);
+        float shrink = xyz > 0.0f ? sqrtf(1.0f - bias * bias) / xyz : 0.0f;
+        x *= shrink;
+        y *= shrink;
+        z *= shrink;
+        w = bias;
+    }
+
+    float sign = tangent[3] < 0.0f ? -1.0f : 1.0f;
+    out[0] = x * sign;
+    out[1] = y * sign;
+    out[2] = z * sign;
+    out[3] = w * sign;
+}
+
+/* Stores the components of one vertex in the output's format. */
+static void ltcEncodeVertex(const LtcAttribOutput *output, uint8_t *dst, const float *values)
+{
+    float oct[2];
+    switch(output->m_format)
+    {
+    case LTC_VERTEX_ATTRIB_FORMAT_HALF:
+        for(uint32_t c = 0; c < output->m_numComponents; ++c)
+            *(uint16_t *)(dst + c * output->m_componentStride) = ltcFloatToHalf(values[c]);
+        break;
+    case LTC_VERTEX_ATTRIB_FORMAT_SNORM16:
+        for(uint32_t c = 0; c < output->m_numComponents; ++c)
+            *(int16_t *)(dst + c * output->m_componentStride) = (int16_t)ltcQuantizeSnorm(values[c], 32767.0f);
+        break;
+    case LTC_VERTEX_ATTRIB_FORMAT_UNORM16:
+        for(uint32_t c = 0; c < output->m_numComponents; ++c)
+            *(uint16_t *)(dst + c * output->m_componentStride) = (uint16_t)ltcQuantizeUnorm(values[c], 65535.0f);
+        break;
+    case LTC_VERTEX_ATTRIB_FORMAT_SNORM_10_10_10_2:
+    {
+        uint32_t packed = ((uint32_t)ltcQuantizeSnorm(values[0], 511.0f) & 0x3FFu) |
+                          ((uint32_t)ltcQuantizeSnorm(values[1], 511.0f) & 0x3FFu) << 10 |
+                          ((uint32_t)ltcQuantizeSnorm(values[2], 511.0f) & 0x3FFu) << 20;
+        if(output->m_numComponents == 4)
+            packed |= ((uint32_t)ltcQuantizeSnorm(values[3], 1.0f) & 0x3u) << 30;
+        *(uint32_t *)dst = packed;
+        break;
+    }
+    case LTC_VERTEX_ATTRIB_FORMAT_OCT_SNORM16:
+        ltcOctEncode(values, oct);
+        *(uint32_t *)dst = ((uint32_t)ltcQuantizeSnorm(oct[0], 32767.0f) & 0xFFFFu) |
+                           ((uint32_t)ltcQuantizeSnorm(oct[1], 32767.0f) & 0xFFFFu) << 16;
+        break;
+    case LTC_VERTEX_ATTRIB_FORMAT_OCT_SNORM8:
+        ltcOctEncode(values, oct);
+        *(uint16_t *)dst = (uint16_t)(((uint32_t)ltcQuantizeSnorm(oct[0], 127.0f) & 0xFFu) |
+                                      ((uint32_t)ltcQuantizeSnorm(oct[1], 127.0f) & 0xFFu) << 8);
+        break;
+    default:
+        for(uint32_t c = 0; c < output->m_numComponents; ++c)
+            *(float *)(dst + c * output->m_componentStride) = values[c];
+        break;
+    }
+}
+
+static void ltcWriteVertex(const LtcVertexWriter *writer, uint32_t vertex, const LtcSurfacePoint *point, float u, float v, float handedness)
+{
+    float values[LTC_VERTEX_ATTRIB_COUNT][4] =
+    {
+        { point->m_position[0], point->m_position[1], point->m_position[2], 1.0f },
+        { point->m_normal[0], point->m_normal[1], point->m_normal[2], 0.0f },
+        { u, v, 0.0f, 0.0f },
+        { point->m_tangent[0], point->m_tangent[1], point->m_tangent[2], handedness },
+        { 0.0f, 0.0f, 0.0f, 0.0f },
+        { 0.0f, 0.0f, 0.0f, 0.0f },
+    };
+    ltcCross(point->m_normal, point->m_tangent, values[4]);
+    ltcSet3(values[4], values[4][0] * handedness, values[4][1] * handedness, values[4][2] * handedness);
+
+    for(uint32_t o = 0; o < writer->m_numOutputs; ++o)
+    {
+        const LtcAttribOutput *output = &writer->m_outputs[o];
+        uint8_t *dst = output->m_buffer + (size_t)vertex * output->m_stride;
+        if(output->m_slot == LTC_QTANGENT_SLOT)
+            ltcQTangent(values[1], values[3], values[LTC_QTANGENT_SLOT]);
+        ltcEncodeVertex(output, dst, values[output->m_slot]);
+    }
+}
+
+#define LTC_ROW_BLOCK 64
+
+/* Float components stored one after the other, as in SoA streams. */
+static int ltcIsFloatStream(const LtcAttribOutput *output)
+{
+    return output->m_slot != LTC_QTANGENT_SLOT && output->m_format == LTC_VERTEX_ATTRIB_FORMAT_FLOAT &&
+           output->m_stride == sizeof(float);
+}
+
+/* Stores count vertices of adjacent float components, one vertex at a time so
+ * each one is written with a single pass over its bytes. Four components go
+ * through a 4 x 4 transpose. */
+static void ltcInterleaveRow(uint8_t *dst, size_t stride, const float *const src[4], uint32_t start,
+                             uint32_t numComponents, uint32_t count)
+{
+    const float *x = src[0] + start, *y = src[1] + start, *z = src[2] + start, *w = src[3] + start;
+    uint32_t i = 0;
+    switch(numComponents)
+    {
+    case 4:
+#if LTC_SIMD_WIDTH >= 4
+        for(; i + 4 <= count; i += 4)
+        {
+            __m128 r0 = _mm_loadu_ps(x + i), r1 = _mm_loadu_ps(y + i), r2 = _mm_loadu_ps(z + i), r3 = _mm_loadu_ps(w + i);
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+            _mm_storeu_ps((float *)(dst + (i + 0) * stride), r0);
+            _mm_storeu_ps((float *)(dst + (i + 1) * stride), r1);
+            _mm_storeu_ps((float *)(dst + (i + 2) * stride), r2);
+            _mm_storeu_ps((float *)(dst + (i + 3) * stride), r3);
+        }
+#endif
+        for(; i < count; ++i)
+        {
+            float *out = (float *)(dst + i * stride);
+            out[0] = x[i];
+            out[1] = y[i];
+            out[2] = z[i];
+            out[3] = w[i];
+        }
+        break;
+    case 3:
+        for(; i < count; ++i)
+        {
+            float *out = (float *)(dst + i * stride);
+            out[0] = x[i];
+            out[1] = y[i];
+            out[2] = z[i];
+        }
+        break;
+    default:
+        for(; i < count; ++i)
+        {
+            float *out = (float *)(dst + i * stride);
+            out[0] = x[i];
+            out[1] = y[i];
+        }
+        break;
+    }
+}
+
+#define LTC_MAX_PACKED_FLOATS 20
+
+/* Float outputs that tile one interleaved vertex exactly: the float at k in
+ * every vertex is component m_component[k] of slot m_slot[k]. */
+typedef struct
+{
+    uint8_t *m_buffer;
+    uint32_t m_numFloats;
+    uint8_t  m_slot[LTC_MAX_PACKED_FLOATS];
+    uint8_t  m_component[LTC_MAX_PACKED_FLOATS];
+} LtcPackedVertex;
+
+/* Leaves m_numFloats at 0 unless the outputs are float elements of one
+ * buffer covering every byte of the vertex stride. */
+static void ltcInitPackedVertex(const LtcVertexWriter *writer, LtcPackedVertex *packed)
+{
+    packed->m_buffer    = NULL;
+    packed->m_numFloats = 0;
+    if(writer->m_numOutputs == 0)
+        return;
+
+    uintptr_t base = (uintptr_t)writer->m_outputs[0].m_buffer;
+    size_t stride = writer->m_outputs[0].m_stride;
+    for(uint32_t o = 1; o < writer->m_numOutputs; ++o)
+    {
+        if((uintptr_t)writer->m_outputs[o].m_buffer < base)
+            base = (uintptr_t)writer->m_outputs[o].m_buffer;
+    }
+    if(stride % sizeof(float) || stride / sizeof(float) > LTC_MAX_PACKED_FLOATS)
+        return;
+
+    uint32_t numFloats = (uint32_t)(stride / sizeof(float));
+    uint32_t covered = 0;
+    for(uint32_t o = 0; o < writer->m_numOutputs; ++o)
+    {
+        const LtcAttribOutput *output = &writer->m_outputs[o];
+        uintptr_t offset = (uintptr_t)output->m_buffer - base;
+        if(output->m_slot == LTC_QTANGENT_SLOT || output->m_format != LTC_VERTEX_ATTRIB_FORMAT_FLOAT ||
+           output->m_componentStride != sizeof(float) || output->m_stride != stride || offset % sizeof(float) ||
+           offset + output->m_numComponents * sizeof(float) > stride)
+            return;
+        for(uint32_t c = 0; c < output->m_numComponents; ++c)
+        {
+            uint32_t k = (uint32_t)(offset / sizeof(float)) + c;
+            if(covered & (1u << k))
+                return;
+            covered |= 1u << k;
+            packed->m_slot[k]      = (uint8_t)output->m_slot;
+            packed->m_component[k] = (uint8_t)c;
+        }
+    }
+    if(covered != (1u << numFloats) - 1)
+        return;
+
+    packed->m_buffer    = (uint8_t *)base;
+    packed->m_numFloats = numFloats;
+}
+
+#if LTC_SIMD_WIDTH >= 4
+/* Transposes four components of vertices i to i + 3 from their rows (NULL
+ * for zeros) and stores them to dst, dst + numFloats, ... */
+static void ltcStorePackedQuad(float *dst, uint32_t numFloats, const float *const src[4], uint32_t i)
+{
+    __m128 r0 = src[0] ? _mm_loadu_ps(src[0] + i) : _mm_setzero_ps();
+    __m128 r1 = src[1] ? _mm_loadu_ps(src[1] + i) : _mm_setzero_ps();
+    __m128 r2 = src[2] ? _mm_loadu_ps(src[2] + i) : _mm_setzero_ps();
+    __m128 r3 = src[3] ? _mm_loadu_ps(src[3] + i) : _mm_setzero_ps();
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    _mm_storeu_ps(dst, r0);
+    _mm_storeu_ps(dst + numFloats, r1);
+    _mm_storeu_ps(dst + 2 * numFloats, r2);
+    _mm_storeu_ps(dst + 3 * numFloats, r3);
+}
+
+#endif
+
+/* Stores count vertices of numFloats floats to dst, float k coming from
+ * src[k], four floats of four vertices per 4 x 4 transpose. When the vertex
+ * size is not a multiple of four floats the last quad runs into the next
+ * vertex, so it goes first and is overwritten by the others; the final
+ * vertices are stored one float at a time. src is padded with NULL to a
+ * multiple of four. */
+static void ltcPackRow(float *dst, uint32_t numFloats, const float *const src[LTC_MAX_PACKED_FLOATS], uint32_t count)
+{
+    uint32_t i = 0;
+#if LTC_SIMD_WIDTH >= 4
+    uint32_t lastQuad = 4 * ((numFloats - 1) / 4);
+    for(; i + 4 < count; i += 4)
+    {
+        float *vertex = dst + (size_t)i * numFloats;
+        ltcStorePackedQuad(vertex + lastQuad, numFloats, src + lastQuad, i);
+        for(uint32_t q = 0; q < lastQuad; q += 4)
+            ltcStorePackedQuad(vertex + q, numFloats, src + q, i);
+    }
+#endif
+    for(; i < count; ++i)
+    {
+        for(uint32_t k = 0; k < numFloats; ++k)
+            dst[(size_t)i * numFloats + k] = src[k][i];
+    }
+}
+
+/* dst[i] = src[i] * scale[p] * extra[p] with p = i % period, period being a
+ * multiple of four, a whole period at a time so the pattern stays in
+ * registers or L1 without wrapping inside the SIMD loop. */
+static void ltcScalePacked(float *dst, const float *src, const float *scale, const float *extra, uint32_t period,
+                           size_t count)
+{
+    size_t i = 0;
+#if LTC_SIMD_WIDTH >= 4
+    for(; i + period <= count; i += period)
+    {
+        for(uint32_t p = 0; p < period; p += 4)
+        {
+            __m128 scaled = _mm_mul_ps(_mm_loadu_ps(src + i + p), _mm_loadu_ps(scale + p));
+            _mm_storeu_ps(dst + i + p, _mm_mul_ps(scaled, _mm_loadu_ps(extra + p)));
+        }
+    }
+#endif
+    for(uint32_t p = 0; i < count; ++i, p = p + 1 < period ? p + 1 : 0)
+        dst[i] = src[i] * scale[p] * extra[p];
+}
+
+/* Writes count consecutive vertices given one array per attribute component,
+ * so each output is filled with contiguous or strided copies. Strided outputs
+ * go in blocks small enough that interleaved vertices stay in L1 while every
+ * component of the block is written. */
+static void ltcWriteRow(const LtcVertexWriter *writer, uint32_t firstVertex, uint32_t count,
+                        const float *const rows[LTC_VERTEX_ATTRIB_COUNT][4])
+{
+    for(uint32_t start = 0; start < count; start += LTC_ROW_BLOCK)
+    {
+        uint32_t blockSize = count - start < LTC_ROW_BLOCK ? count - start : LTC_ROW_BLOCK;
+        for(uint32_t o = 0; o < writer->m_numOutputs; ++o)
+        {
+            const LtcAttribOutput *output = &writer->m_outputs[o];
+            uint8_t *dst = output->m_buffer + (size_t)(firstVertex + start) * output->m_stride;
+            if(output->m_slot == LTC_QTANGENT_SLOT)
+            {
+                /* derived from the normal and tangent rows */
+                for(uint32_t i = 0; i < blockSize; ++i)
+                {
+                    float normal[3], tangent[4], values[4];
+                    for(uint32_t c = 0; c < 4; ++c)
+                        tangent[c] = rows[3][c][start + i];
+                    for(uint32_t c = 0; c < 3; ++c)
+                        normal[c] = rows[1][c][start + i];
+                    ltcQTangent(normal, tangent, values);
+                    ltcEncodeVertex(output, dst + i * output->m_stride, values);
+                }
+                continue;
+            }
+            if(output->m_format != LTC_VERTEX_ATTRIB_FORMAT_FLOAT)
+            {
+                for(uint32_t i = 0; i < blockSize; ++i)
+                {
+                    float values[4];
+                    for(uint32_t c = 0; c < output->m_numComponents; ++c)
+                        values[c] = rows[output->m_slot][c][start + i];
+                    ltcEncodeVertex(output, dst + i * output->m_stride, values);
+                }
+                continue;
+            }
+            if(output->m_componentStride == sizeof(float) && output->m_numComponents > 1)
+            {
+                ltcInterleaveRow(dst, output->m_stride, rows[output->m_slot], start, output->m_numComponents, blockSize);
+                continue;
+            }
+            for(uint32_t c = 0; c < output->m_numComponents; ++c)
+            {
+                const float *src = rows[output->m_slot][c] + start;
+                uint8_t *out = dst + c * output->m_componentStride;
+                if(output->m_stride == sizeof(float))
+                {
+                    memcpy(out, src, blockSize * sizeof(float));
+                    continue;
+                }
+                for(uint32_t i = 0; i < blockSize; ++i)
+                    *(float *)(out + i * output->m_stride) = src[i];
+            }
+        }
+    }
+}
+
+/* (src * scale) * extra, rounded after each multiply. */
+static void ltcScaleRow2(float *dst, const float *src, float scale, float extra, uint32_t count)
+{
+    uint32_t i = 0;
+#if LTC_SIMD_WIDTH == 8
+    __m256 s = _mm256_set1_ps(scale), e = _mm256_set1_ps(extra);
+    for(; i + 8 <= count; i += 8)
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i), s), e));
+#elif LTC_SIMD_WIDTH == 4
+    __m128 s = _mm_set1_ps(scale), e = _mm_set1_ps(extra);
+    for(; i + 4 <= count; i += 4)
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(src + i), s), e));
+#endif
+    for(; i < count; ++i)
+        dst[i] = src[i] * scale * extra;
+}
+
+static void ltcFillRow(float *dst, float value, uint32_t count)
+{
+    uint32_t i = 0;
+#if LTC_SIMD_WIDTH == 8
+    __m256 v = _mm256_set1_ps(value);
+    for(; i + 8 <= count; i += 8)
+        _mm256_storeu_ps(dst + i, v);
+#elif LTC_SIMD_WIDTH == 4
+    __m128 v = _mm_set1_ps(value);
+    for(; i + 4 <= count; i += 4)
+        _mm_storeu_ps(dst + i, v);
+#endif
+    for(; i < count; ++i)
+        dst[i] = value;
+}
+
+#define LTC_SPHERE_TABLE  1024
+#define LTC_SPHERE_PACKED 256
+
+/* One vertex component along a sphere row: m_table[i] * m_scale * m_extra,
+ * or the constant m_scale * m_extra without a table. */
+typedef struct
+{
+    const float *m_table;
+    float        m_scale;
+    float        m_extra;
+} LtcRowTerm;
+
+enum { LTC_SIN_T, LTC_COS_T, LTC_NEG_SIN_T, LTC_U, LTC_NUM_SPHERE_TABLES };
+
+/* The terms of every component of row j, given the longitude tables. */
+static void ltcSphereRowTerms(const LtcPatch *patch, const float table[LTC_NUM_SPHERE_TABLES][LTC_SPHERE_TABLE],
+                              uint32_t j, LtcRowTerm terms[LTC_QTANGENT_SLOT][4])
+{
+    const LtcConfigSphere *config = (const LtcConfigSphere *)patch->m_config;
+    float radius = config->m_radius;
+    float phi = patch->m_side - LTC_PI * ltcParam(j, patch->m_divV);
+    float s = sinf(phi);
+    float c = cosf(phi);
+    float v = ltcParam(j, patch->m_divV);
+    const float *sinT = table[LTC_SIN_T], *cosT = table[LTC_COS_T], *negSinT = table[LTC_NEG_SIN_T];
+
+    const LtcRowTerm rowTerms[LTC_QTANGENT_SLOT][4] =
+    {
+        { { sinT, s, radius }, { NULL, c, radius }, { cosT, s, radius }, { NULL, 1.0f, 1.0f } },
+        { { sinT, s, 1.0f }, { NULL, c, 1.0f }, { cosT, s, 1.0f }, { NULL, 0.0f, 1.0f } },
+        { { table[LTC_U], 1.0f, 1.0f }, { NULL, v, 1.0f }, { NULL, 0.0f, 1.0f }, { NULL, 0.0f, 1.0f } },
+        { { cosT, 1.0f, 1.0f }, { NULL, 0.0f, 1.0f }, { negSinT, 1.0f, 1.0f }, { NULL, 1.0f, 1.0f } },
+        { { negSinT, c, 1.0f }, { NULL, s, 1.0f }, { cosT, -c, 1.0f }, { NULL, 0.0f, 1.0f } },
+    };
+    memcpy(terms, rowTerms, sizeof(rowTerms));
+}
+
+/* Sphere from one longitude and one latitude sin/cos table: every vertex
+ * component is a longitude table entry scaled by its row's latitude terms, so
+ * the per-vertex work is a handful of SIMD multiplies and no trigonometry.
+ * The longitude table covers LTC_SPHERE_TABLE columns; rows are written in
+ * order within each such band, so stores stay sequential even on very large
+ * spheres. Float streams are computed in place. Packed interleaved vertices
+ * are built from the table alone once per LTC_SPHERE_PACKED columns, then
+ * every row of those is a copy scaled by a repeating pattern of its terms.
+ * Other outputs go through row blocks and ltcWriteRow. */
+static void ltcEmitSphere(const LtcPatch *patch, uint32_t copy, uint32_t rowBegin, uint32_t rowEnd,
+                          const LtcVertexWriter *writer, uint32_t firstVertex)
+{
+    enum
+    {
+        ZERO, ONE, NX, NY, NZ, PX, PY, PZ, BX, BY, BZ, V,
+        NUM_ROWS
+    };
+    uint32_t rowSize = patch->m_divU + 1;
+    float table[LTC_NUM_SPHERE_TABLES][LTC_SPHERE_TABLE];
+    float row[NUM_ROWS][LTC_ROW_BLOCK];
+    float packedTable[LTC_SPHERE_PACKED * LTC_MAX_PACKED_FLOATS];
+    float packedScale[2][4 * LTC_MAX_PACKED_FLOATS];
+    (void)copy;
+
+    LtcVertexWriter blocked;
+    const LtcAttribOutput *streams[LTC_VERTEX_ATTRIB_COUNT];
+    uint32_t numStreams = 0;
+    blocked.m_numOutputs = 0;
+    for(uint32_t o = 0; o < writer->m_numOutputs; ++o)
+    {
+        if(ltcIsFloatStream(&writer->m_outputs[o]))
+            streams[numStreams++] = &writer->m_outputs[o];
+        else
+            blocked.m_outputs[blocked.m_numOutputs++] = writer->m_outputs[o];
+    }
+    LtcPackedVertex packed;
+    ltcInitPackedVertex(&blocked, &packed);
+    uint32_t numFloats = packed.m_numFloats;
+    int blockRows = blocked.m_numOutputs && !numFloats;
+
+    ltcFillRow(row[ZERO], 0.0f, LTC_ROW_BLOCK);
+    ltcFillRow(row[ONE], 1.0f, LTC_ROW_BLOCK);
+
+    for(uint32_t tableStart = 0; tableStart < rowSize; tableStart += LTC_SPHERE_TABLE)
+    {
+        uint32_t tableCount = rowSize - tableStart < LTC_SPHERE_TABLE ? rowSize - tableStart : LTC_SPHERE_TABLE;
+        for(uint32_t i = 0; i < tableCount; ++i)
+        {
+            float theta = 2.0f * LTC_PI * ltcParam(tableStart + i, patch->m_divU);
+            table[LTC_SIN_T][i]     = sinf(theta);
+            table[LTC_COS_T][i]     = cosf(theta);
+            table[LTC_NEG_SIN_T][i] = -table[LTC_SIN_T][i];
+            table[LTC_U][i]         = ltcParam(tableStart + i, patch->m_divU);
+        }
+
+        for(uint32_t j = rowBegin; j < rowEnd && (numStreams || blockRows); ++j)
+        {
+            LtcRowTerm terms[LTC_QTANGENT_SLOT][4];
+            ltcSphereRowTerms(patch, (const float (*)[LTC_SPHERE_TABLE])table, j, terms);
+            uint32_t rowFirst = firstVertex + (j - rowBegin) * rowSize + tableStart;
+
+            for(uint32_t o = 0; o < numStreams; ++o)
+            {
+                for(uint32_t k = 0; k < streams[o]->m_numComponents; ++k)
+                {
+                    const LtcRowTerm *term = &terms[streams[o]->m_slot][k];
+                    float *dst = (float *)(streams[o]->m_buffer + k * streams[o]->m_componentStride) + rowFirst;
+                    if(term->m_table)
+                        ltcScaleRow2(dst, term->m_table, term->m_scale, term->m_extra, tableCount);
+                    else
+                        ltcFillRow(dst, term->m_scale * term->m_extra, tableCount);
+                }
+            }
+            if(!blockRows)
+                continue;
+
+            /* NY, PY, BY and V are the constant terms */
+            ltcFillRow(row[NY], terms[1][1].m_scale, LTC_ROW_BLOCK);
+            ltcFillRow(row[PY], terms[0][1].m_scale * terms[0][1].m_extra, LTC_ROW_BLOCK);
+            ltcFillRow(row[BY], terms[4][1].m_scale, LTC_ROW_BLOCK);
+            ltcFillRow(row[V], terms[2][1].m_scale, LTC_ROW_BLOCK);
+
+            for(uint32_t start = 0; start < tableCount; start += LTC_ROW_BLOCK)
+            {
+                uint32_t count = tableCount - start < LTC_ROW_BLOCK ? tableCount - start : LTC_ROW_BLOCK;
+                const float *sinT = table[LTC_SIN_T] + start, *cosT = table[LTC_COS_T] + start;
+                const float *negSinT = table[LTC_NEG_SIN_T] + start;
+                ltcScaleRow2(row[NX], sinT, terms[1][0].m_scale, 1.0f, count);
+                ltcScaleRow2(row[NZ], cosT, terms[1][2].m_scale, 1.0f, count);
+                ltcScaleRow2(row[PX], sinT, terms[0][0].m_scale, terms[0][0].m_extra, count);
+                ltcScaleRow2(row[PZ], cosT, terms[0][2].m_scale, terms[0][2].m_extra, count);
+                ltcScaleRow2(row[BX], negSinT, terms[4][0].m_scale, 1.0f, count);
+                ltcScaleRow2(row[BZ], cosT, terms[4][2].m_scale, 1.0f, count);
+
+                const float *const rows[LTC_VERTEX_ATTRIB_COUNT][4] =
+                {
+                    { row[PX], row[PY], row[PZ], row[ONE] },
+                    { row[NX], row[NY], row[NZ], row[ZERO] },
+                    { table[LTC_U] + start, row[V], row[ZERO], row[ZERO] },
+                    { cosT, row[ZERO], negSinT, row[ONE] },
+                    { row[BX], row[BY], row[BZ], row[ZERO] },
+                };
+                ltcWriteRow(&blocked, rowFirst + start, count, rows);
+            }
+        }
+
+        for(uint32_t packedStart = 0; numFloats && packedStart < tableCount; packedStart += LTC_SPHERE_PACKED)
+        {
+            uint32_t packedCount = tableCount - packedStart < LTC_SPHERE_PACKED ? tableCount - packedStart : LTC_SPHERE_PACKED;
+            LtcRowTerm terms[LTC_QTANGENT_SLOT][4];
+            ltcSphereRowTerms(patch, (const float (*)[LTC_SPHERE_TABLE])table, rowBegin, terms);
+
+            /* the table entries, or 1 for constant components */
+            for(uint32_t start = 0; start < packedCount; start += LTC_ROW_BLOCK)
+            {
+                uint32_t count = packedCount - start < LTC_ROW_BLOCK ? packedCount - start : LTC_ROW_BLOCK;
+                const float *src[LTC_MAX_PACKED_FLOATS] = { NULL };
+                for(uint32_t k = 0; k < numFloats; ++k)
+                {
+                    const LtcRowTerm *term = &terms[packed.m_slot[k]][packed.m_component[k]];
+                    src[k] = term->m_table ? term->m_table + packedStart + start : row[ONE];
+                }
+                ltcPackRow(packedTable + (size_t)start * numFloats, numFloats, src, count);
+            }
+
+            for(uint32_t j = rowBegin; j < rowEnd; ++j)
+            {
+                ltcSphereRowTerms(patch, (const float (*)[LTC_SPHERE_TABLE])table, j, terms);
+
+                /* the factors of four vertices span whole quads */
+                for(uint32_t n = 0; n < 4 * numFloats; n += numFloats)
+                {
+                    for(uint32_t k = 0; k < numFloats; ++k)
+                    {
+                        const LtcRowTerm *term = &terms[packed.m_slot[k]][packed.m_component[k]];
+                        packedScale[0][n + k] = term->m_scale;
+                        packedScale[1][n + k] = term->m_extra;
+                    }
+                }
+                uint32_t rowFirst = firstVertex + (j - rowBegin) * rowSize + tableStart + packedStart;
+                ltcScalePacked((float *)packed.m_buffer + (size_t)rowFirst * numFloats, packedTable, packedScale[0],
+                               packedScale[1], 4 * numFloats, (size_t)packedCount * numFloats);
+            }
+        }
+    }
+}
+
+/* Repeats the last vertex into the padding lanes at the end of each stream so
+ * SIMD consumers can process whole registers. */
+void ltcPadVertexStreams(const LtcVertexWriter *writer, uint32_t numVertices)
+{
+    for(uint32_t o = 0; o < writer->m_numOutputs; ++o)
+    {
+        const LtcAttribOutput *output = &writer->m_outputs[o];
+        if(!output->m_streamed || numVertices == 0)
+            continue;
+
+        for(uint32_t c = 0; c < output->m_numStored; ++c)
+        {
+            uint8_t *stream = output->m_buffer + c * output->m_componentStride;
+            const uint8_t *last = stream + (size_t)(numVertices - 1) * output->m_stride;
+            for(size_t at = (size_t)numVertices * output->m_stride; at + output->m_componentSize <= output->m_componentStride; at += output->m_stride)
+                memcpy(stream + at, last, output->m_componentSize);
+        }
+    }
+}
+
+uint32_t ltcReadIndex(const LtcIndexBuffer *indices, uint32_t at)
+{
+    switch(indices->m_indexSize)
+    {
+    case LTC_INDEX_SIZE_8:
+        return ((const uint8_t *)indices->m_buffer)[at];
+    case LTC_INDEX_SIZE_16:
+        return ((const uint16_t *)indices->m_buffer)[at];
+    default:
+        return ((const uint32_t *)indices->m_buffer)[at];
+    }
+}
+
+void ltcWriteIndex(const LtcIndexBuffer *indices, uint32_t at, uint32_t index)
+{
+    switch(indices->m_indexSize)
+    {
+    case LTC_INDEX_SIZE_8:
+        ((uint8_t *)indices->m_buffer)[at] = (uint8_t)index;
+        break;
+    case LTC_INDEX_SIZE_16:
+        ((uint16_t *)indices->m_buffer)[at] = (uint16_t)index;
+        break;
+    default:
+        ((uint32_t *)indices->m_buffer)[at] = index;
+        break;
+    }
+}
+
+/* Position of quad row j's first index within one patch copy. */
+static uint32_t ltcQuadRowFirstIndex(const LtcPatch *patch, uint32_t j)
+{
+    if(patch->m_config->m_indexTopology == LTC_INDEX_TOPOLOGY_TRIANGLE_STRIP)
+        return j * ltcStripRowIndexCount(patch);
+    uint32_t triangles = 2 * j;
+    if(j > 0 && (patch->m_flags & LTC_PATCH_COLLAPSE_V0))
+        --triangles;
+    if(j == patch->m_divV && (patch->m_flags & LTC_PATCH_COLLAPSE_V1))
+        --triangles;
+    return 3 * patch->m_divU * triangles;
+}
+
+uint32_t ltcQuadRowsIndexCount(const LtcPatch *patch, uint32_t rowBegin, uint32_t rowEnd)
+{
+    return ltcQuadRowFirstIndex(patch, rowEnd) - ltcQuadRowFirstIndex(patch, rowBegin);
+}
+
+/* Zigzags over each row starting on its upper vertices, which keeps the
+ * list's (i, j) - (i + 1, j + 1) diagonals; the other winding starts with a
+ * repeated vertex to swap the triangle parity. */
+static void ltcWritePatchStrips(const LtcPatch *patch, const LtcIndexBuffer *indices, uint32_t rowBegin, uint32_t rowEnd,
+                               uint32_t at, uint32_t base, int flipWinding)
+{
+    uint32_t rowSize = patch->m_divU + 1;
+    uint32_t restart = ltcGetPrimitiveRestartIndex(indices->m_indexSize);
+    for(uint32_t j = rowBegin; j < rowEnd; ++j)
+    {
+        uint32_t lower = base + (j - rowBegin) * rowSize;
+        uint32_t upper = lower + rowSize;
+        if(flipWinding)
+            ltcWriteIndex(indices, at++, upper);
+        for(uint32_t i = 0; i < rowSize; ++i)
+        {
+            ltcWriteIndex(indices, at++, upper + i);
+            ltcWriteIndex(indices, at++, lower + i);
+        }
+        ltcWriteIndex(indices, at++, restart);
+    }
+}
+
+/* Quads of rows [rowBegin, rowEnd); vertex row rowBegin starts at base. */
+static void ltcWritePatchIndices(const LtcPatch *patch, const LtcIndexBuffer *indices, uint32_t rowBegin, uint32_t rowEnd,
+                                 uint32_t at, uint32_t base, int flipWinding)
+{
+    if(patch->m_config->m_indexTopology == LTC_INDEX_TOPOLOGY_TRIANGLE_STRIP)
+    {
+        ltcWritePatchStrips(patch, indices, rowBegin, rowEnd, at, base, flipWinding);
+        return;
+    }
+
+    uint32_t rowSize = patch->m_divU + 1;
+    for(uint32_t j = rowBegin; j < rowEnd; ++j)
+    {
+        int skipLower = j == 0 && (patch->m_flags & LTC_PATCH_COLLAPSE_V0);
+        int skipUpper = j == patch->m_divV - 1 && (patch->m_flags & LTC_PATCH_COLLAPSE_V1);
+        for(uint32_t i = 0; i < patch->m_divU; ++i)
+        {
+            uint32_t i0 = base + (j - rowBegin) * rowSize + i;
+            uint32_t i1 = i0 + 1;
+            uint32_t i3 = i0 + rowSize;
+            uint32_t i2 = i3 + 1;
+            if(!skipLower)
+            {
+                ltcWriteIndex(indices, at++, i0);
+                ltcWriteIndex(indices, at++, flipWinding ? i2 : i1);
+                ltcWriteIndex(indices, at++, flipWinding ? i1 : i2);
+            }
+            if(!skipUpper)
+            {
+                ltcWriteIndex(indices, at++, i0);
+                ltcWriteIndex(indices, at++, flipWinding ? i3 : i2);
+                ltcWriteIndex(indices, at++, flipWinding ? i2 : i3);
+            }
+        }
+    }
+}
+
+int ltcPatchFlipWinding(const LtcPatch *patch)
+{
+    int flipped = (patch->m_flags & LTC_PATCH_FLIP) != 0;
+    return flipped != (patch->m_config->m_windingOrder == LTC_WINDING_ORDER_CLOCKWISE);
+}
+
+uint32_t ltcQuadTriangles(const LtcPatch *patch, uint32_t j, int flipWinding, uint8_t corners[6])
+{
+    uint32_t numTriangles = 0;
+    if(!(j == 0 && (patch->m_flags & LTC_PATCH_COLLAPSE_V0)))
+    {
+        corners[3 * numTriangles + 0] = 0;
+        corners[3 * numTriangles + 1] = flipWinding ? 2 : 1;
+        corners[3 * numTriangles + 2] = flipWinding ? 1 : 2;
+        ++numTriangles;
+    }
+    if(!(j == patch->m_divV - 1 && (patch->m_flags & LTC_PATCH_COLLAPSE_V1)))
+    {
+        corners[3 * numTriangles + 0] = 0;
+        corners[3 * numTriangles + 1] = flipWinding ? 3 : 2;
+        corners[3 * numTriangles + 2] = flipWinding ? 2 : 3;
+        ++numTriangles;
+    }
+    return numTriangles;
+}
+
+static void ltcEmitPieceVertices(const LtcEmitPiece *piece, const LtcVertexWriter *writer)
+{
+    const LtcPatch *patch = piece->m_patch;
+    if(patch->m_emit)
+    {
+        patch->m_emit(patch, piece->m_copy, piece->m_rowBegin, piece->m_rowEnd, writer, piece->m_firstVertex);
+        return;
+    }
+
+    float handedness = (patch->m_flags & LTC_PATCH_FLIP) ? -1.0f : 1.0f;
+    uint32_t vertex = piece->m_firstVertex;
+    for(uint32_t j = piece->m_rowBegin; j < piece->m_rowEnd; ++j)
+    {
+        float v = ltcParam(j, patch->m_divV);
+        for(uint32_t i = 0; i <= patch->m_divU; ++i)
+        {
+            LtcSurfacePoint point;
+            patch->m_eval(patch, piece->m_copy, i, j, &point);
+            ltcWriteVertex(writer, vertex++, &point, ltcParam(i, patch->m_divU), v, handedness);
+        }
+    }
+}
+
+void ltcEmitPiece(const LtcEmitPiece *piece, const LtcVertexWriter *writer, const LtcIndexBuffer *indices)
+{
+    const LtcPatch *patch = piece->m_patch;
+
+    /* index-only output, as for index templates, evaluates nothing */
+    if(writer->m_numOutputs)
+        ltcEmitPieceVertices(piece, writer);
+
+    if(indices && piece->m_rowBegin < piece->m_quadEnd)
+        ltcWritePatchIndices(patch, indices, piece->m_rowBegin, piece->m_quadEnd, piece->m_firstIndex,
+                             piece->m_firstVertex - piece->m_indexBase, ltcPatchFlipWinding(patch));
+}
+
+/* ---- parallel emit ----------------------------------------------------- */
+
+typedef struct
+{
+    const LtcEmitPiece    *m_pieces;
+    const uint32_t        *m_taskStart;
+    const LtcVertexWriter *m_writer;
+    const LtcIndexBuffer  *m_indices;
+} LtcEmitJob;
+
+static void ltcRunEmitTask(void *taskData, uint32_t task)
+{
+    const LtcEmitJob *job = (const LtcEmitJob *)taskData;
+    for(uint32_t p = job->m_taskStart[task]; p < job->m_taskStart[task + 1]; ++p)
+        ltcEmitPiece(&job->m_pieces[p], job->m_writer, job->m_indices);
+}
+
+LtcError_t ltcEmitPieces(const LtcEmitPiece *pieces, uint32_t numPieces, uint32_t numVertices, const LtcAllocator *allocator,
+                         const LtcTaskInterface *taskInterface, const LtcVertexWriter *writer, const LtcIndexBuffer *indices)
+{
+    if(!taskInterface || taskInterface->m_numWorkers < 2 || numVertices < 2 * LTC_TASK_VERTICES)
+    {
+        for(uint32_t p = 0; p < numPieces; ++p)
+            ltcEmitPiece(&pieces[p], writer, indices);
+        return LTC_OK;
+    }
+
+    uint32_t *taskStart = (uint32_t *)allocator->m_alloc(((size_t)numPieces + 1) * sizeof(uint32_t), allocator->m_userData);
+    if(!taskStart)
+        return LTC_ERR_OUTOFMEMORY;
+
+    /* group consecutive small pieces so every task carries a similar load */
+    uint32_t numTasks = 0;
+    uint32_t load = LTC_TASK_VERTICES;
+    for(uint32_t p = 0; p < numPieces; ++p)
+    {
+        if(load >= LTC_TASK_VERTICES)
+        {
+            taskStart[numTasks++] = p;
+            load = 0;
+        }
+        load += (pieces[p].m_rowEnd - pieces[p].m_rowBegin) * (pieces[p].m_patch->m_divU + 1);
+    }
+    taskStart[numTasks] = numPieces;
+
+    LtcEmitJob job = { pieces, taskStart, writer, indices };
+    void *handle = taskInterface->m_enqueue(ltcRunEmitTask, &job, numTasks, taskInterface->m_userData);
+    taskInterface->m_wait(handle, taskInterface->m_userData);
+
+    allocator->m_free(taskStart, allocator->m_userData);
+    return LTC_OK;
+}
+
+/* Walks every patch copy of items in output order, cutting large copies into
+ * row ranges. Returns the number of pieces; fills pieces when not NULL. */
+static uint32_t ltcSplitEmitItems(const LtcEmitItem *items, uint32_t count, LtcEmitPiece *pieces)
+{
+    uint32_t numPieces = 0;
+    for(uint32_t c = 0; c < count; ++c)
+    {
+        const LtcLayout *layout = items[c].m_layout;
+        uint32_t vertex = items[c].m_firstVertex;
+        uint32_t index  = items[c].m_firstIndex;
+        for(uint32_t p = 0; p < layout->m_numPatches; ++p)
+        {
+            const LtcPatch *patch = &layout->m_patches[p];
+            uint32_t rowSize = patch->m_divU + 1;
+            uint32_t rowsPerPiece = LTC_TASK_VERTICES / rowSize ? LTC_TASK_VERTICES / rowSize : 1;
+            for(uint32_t copy = 0; copy < patch->m_count; ++copy)
+            {
+                for(uint32_t row = 0; row <= patch->m_divV; row += rowsPerPiece)
+                {
+                    if(pieces)
+                    {
+                        LtcEmitPiece *piece = &pieces[numPieces];
+                        piece->m_patch       = patch;
+                        piece->m_copy        = copy;
+                        piece->m_rowBegin    = row;
+                        piece->m_rowEnd      = patch->m_divV + 1 - row > rowsPerPiece ? row + rowsPerPiece : patch->m_divV + 1;
+                        piece->m_quadEnd     = piece->m_rowEnd < patch->m_divV ? piece->m_rowEnd : patch->m_divV;
+                        piece->m_firstVertex = vertex + row * rowSize;
+                        piece->m_firstIndex  = index + ltcQuadRowFirstIndex(patch, row);
+                        piece->m_indexBase   = items[c].m_indexBase;
+                    }
+                    ++numPieces;
+                }
+                vertex += ltcPatchVertexCount(patch);
+                index  += ltcPatchIndexCount(patch);
+            }
+        }
+    }
+    return numPieces;
+}
+
+LtcError_t ltcEmitItems(const LtcEmitItem *items, uint32_t count, uint32_t numVertices, const LtcAllocator *allocator,
+                        const LtcTaskInterface *taskInterface, const LtcVertexWriter *writer, const LtcIndexBuffer *indices)
+{
+    if(!taskInterface || taskInterface->m_numWorkers < 2 || numVertices < 2 * LTC_TASK_VERTICES)
+    {
+        for(uint32_t c = 0; c < count; ++c)
+        {
+            const LtcLayout *layout = items[c].m_layout;
+            LtcEmitPiece piece;
+            piece.m_firstVertex = items[c].m_firstVertex;
+            piece.m_firstIndex  = items[c].m_firstIndex;
+            piece.m_indexBase   = items[c].m_indexBase;
+            for(uint32_t p = 0; p < layout->m_numPatches; ++p)
+            {
+                piece.m_patch    = &layout->m_patches[p];
+                piece.m_rowBegin = 0;
+                piece.m_rowEnd   = piece.m_patch->m_divV + 1;
+                piece.m_quadEnd  = piece.m_patch->m_divV;
+                for(piece.m_copy = 0; piece.m_copy < piece.m_patch->m_count; ++piece.m_copy)
+                {
+                    ltcEmitPiece(&piece, writer, indices);
+                    piece.m_firstVertex += ltcPatchVertexCount(piece.m_patch);
+                    piece.m_firstIndex  += ltcPatchIndexCount(piece.m_patch);
+                }
+            }
+        }
+        return LTC_OK;
+    }
+
+    uint32_t numPieces = ltcSplitEmitItems(items, count, NULL);
+    LtcEmitPiece *pieces = (LtcEmitPiece *)allocator->m_alloc((size_t)numPieces * sizeof(LtcEmitPiece), allocator->m_userData);
+    if(!pieces)
+        return LTC_ERR_OUTOFMEMORY;
+    ltcSplitEmitItems(items, count, pieces);
+
+    LtcError_t err = ltcEmitPieces(pieces, numPieces, numVertices, allocator, taskInterface, writer, indices);
+
+    allocator->m_free(pieces, allocator->m_userData);
+    return err;
+}
+
+/* Everything the vertex and index layout depends on, for comparing
+ * generations in ltcUpdateGeometry. config must have passed ltcBuildLayout, so
+ * the shape word is never 0. */
+static void ltcTopologyKey(const LtcConfig *config, uint32_t key[LTC_TOPOLOGY_WORDS])
+{
+    uint32_t div[4] = { 0, 0, 0, 0 };
+    switch(config->m_shape)
+    {
+    case LTC_SHAPE_PLANE:
+    {
+        const LtcConfigPlane *plane = (const LtcConfigPlane *)config;
+        div[0] = plane->m_divX;
+        div[1] = plane->m_divY;
+        break;
+    }
+    case LTC_SHAPE_CUBOID:
+    {
+        const LtcConfigCuboid *cuboid = (const LtcConfigCuboid *)config;
+        div[0] = cuboid->m_divX;
+        div[1] = cuboid->m_divY;
+        div[2] = cuboid->m_divZ;
+        break;
+    }
+    case LTC_SHAPE_SPHERE:
+    {
+        const LtcConfigSphere *sphere = (const LtcConfigSphere *)config;
+        div[0] = sphere->m_divLongitude;
+        div[1] = sphere->m_divLatitude;
+        break;
+    }
+    case LTC_SHAPE_CYLINDER:
+    {
+        const LtcConfigCylinder *cylinder = (const LtcConfigCylinder *)config;
+        div[0] = cylinder->m_divRadial;
+        div[1] = cylinder->m_divAxial;
+        div[2] = cylinder->m_divRings;
+        break;
+    }
+    case LTC_SHAPE_CONE:
+    {
+        const LtcConfigCone *cone = (const LtcConfigCone *)config;
+        div[0] = cone->m_divRadial;
+        div[1] = cone->m_divAxial;
+        div[2] = cone->m_divRings;
+        break;
+    }
+    case LTC_SHAPE_PRISM:
+    {
+        const LtcConfigPrism *prism = (const LtcConfigPrism *)config;
+        div[0] = prism->m_numFacets;
+        div[1] = prism->m_divPerFacetRadial;
+        div[2] = prism->m_divAxial;
+        div[3] = prism->m_divRings;
+        break;
+    }
+    case LTC_SHAPE_PYRAMID:
+    {
+        const LtcConfigPyramid *pyramid = (const LtcConfigPyramid *)config;
+        div[0] = pyramid->m_numFacets;
+        div[1] = pyramid->m_divPerFacetRadial;
+        div[2] = pyramid->m_divAxial;
+        div[3] = pyramid->m_divRings;
+        break;
+    }
+    case LTC_SHAPE_TUBE:
+    {
+        const LtcConfigTube *tube = (const LtcConfigTube *)config;
+        div[0] = tube->m_divRadial;
+        div[1] = tube->m_divAxial;
+        div[2] = tube->m_divRings;
+        break;
+    }
+    case LTC_SHAPE_CAPSULE:
+    {
+        const LtcConfigCapsule *capsule = (const LtcConfigCapsule *)config;
+        div[0] = capsule->m_divRadial;
+        div[1] = capsule->m_divAxial;
+        div[2] = capsule->m_divLatitude;
+        break;
+    }
+    case LTC_SHAPE_TORUS:
+    {
+        const LtcConfigTorus *torus = (const LtcConfigTorus *)config;
+        div[0] = torus->m_divRadialMinor;
+        div[1] = torus->m_divRadialMajor;
+        break;
+    }
+    case LTC_SHAPE_TORUSKNOT:
+    {
+        const LtcConfigTorusKnot *knot = (const LtcConfigTorusKnot *)config;
+        div[0] = knot->m_divRadial;
+        div[1] = knot->m_divTubular;
+        break;
+    }
+    default:
+        break;
+    }
+
+    key[0] = (uint32_t)config->m_shape | (uint32_t)config->m_windingOrder << 8 |
+             (uint32_t)config->m_indexTopology << 16 | (uint32_t)config->m_uvMapping << 24;
+    key[1] = config->m_flags;
+    key[2] = div[0] | div[1] << 16;
+    key[3] = div[2] | div[3] << 16;
+}
+
+LtcError_t ltcGenerateGeometry(const LtcConfig *config, LtcGeometry *outGeometry)
+{
+    if(!config || !outGeometry)
+        return LTC_ERR_INVALIDARGS;
+
+    LtcLayout layout;
+    LtcError_t err = ltcBuildLayout(config, &layout);
+    if(err != LTC_OK)
+        return err;
+
+    LtcGeometrySize size;
+    err = ltcLayoutSize(&layout, &size);
+    if(err != LTC_OK)
+        return err;
+
+    const LtcAllocator *allocator = ltcGetAllocator(config);
+    if(ltcValidateAllocator(allocator) != LTC_OK)
+        return LTC_ERR_INVALIDARGS;
+
+    uint32_t indexRange = ltcIndexRange(config->m_indexTopology, size.m_numVertices);
+    err = ltcValidateBuffers(outGeometry, indexRange);
+    if(err != LTC_OK)
+        return err;
+
+    ltcResolveIndexSize(outGeometry, indexRange);
+    err = ltcAllocateBuffers(allocator, outGeometry, &size);
+    if(err != LTC_OK)
+        return err;
+
+    LtcVertexWriter writer;
+    ltcInitVertexWriter(outGeometry, &writer);
+
+    LtcIndexBuffer indices;
+    LtcEmitItem item = { &layout, 0, 0, 0 };
+    err = ltcEmitItems(&item, 1, size.m_numVertices, allocator, config->m_taskInterface, &writer,
+                       ltcGetWrittenIndices(outGeometry, &indices));
+    if(err == LTC_OK && outGeometry->m_indices)
+        err = ltcOptimizeRange(allocator, config->m_flags, &writer, &indices, 0, size.m_numIndices, 0, 0, size.m_numVertices);
+    if(err != LTC_OK)
+        return err;
+
+    ltcPadVertexStreams(&writer, size.m_numVertices);
+
+    outGeometry->m_numVertices = size.m_numVertices;
+    outGeometry->m_numIndices  = outGeometry->m_indices ? size.m_numIndices : 0;
+    ltcTopologyKey(config, outGeometry->m_topology);
+    return LTC_OK;
+}
+
+/* Whether the normals and tangents change with the dimensions and not just
+ * the positions. */
+static int ltcFrameFollowsSize(LtcShape_t shape)
+{
+    return shape == LTC_SHAPE_CONE || shape == LTC_SHAPE_PRISM || shape == LTC_SHAPE_PYRAMID ||
+           shape == LTC_SHAPE_TORUSKNOT;
+}
+
+LtcError_t ltcUpdateGeometry(const LtcConfig *config, LtcGeometry *geometry)
+{
+    if(!config || !geometry)
+        return LTC_ERR_INVALIDARGS;
+
+    LtcLayout layout;
+    LtcError_t err = ltcBuildLayout(config, &layout);
+    if(err != LTC_OK)
+        return err;
+
+    uint32_t key[LTC_TOPOLOGY_WORDS];
+    ltcTopologyKey(config, key);
+    if(memcmp(key, geometry->m_topology, sizeof(key)) != 0 || (config->m_flags & LTC_CONFIG_FLAG_OPTIMIZE_VERTEX_FETCH))
+        return ltcGenerateGeometry(config, geometry);
+
+    const LtcAllocator *allocator = ltcGetAllocator(config);
+    if(ltcValidateAllocator(allocator) != LTC_OK)
+        return LTC_ERR_INVALIDARGS;
+
+    /* texture coordinates only depend on the grid */
+    LtcVertexWriter all, writer;
+    ltcInitVertexWriter(geometry, &all);
+    writer.m_numOutputs = 0;
+    for(uint32_t o = 0; o < all.m_numOutputs; ++o)
+    {
+        uint32_t slot = all.m_outputs[o].m_slot;
+        if(slot == 0 || (slot != 2 && ltcFrameFollowsSize(config->m_shape)))
+            writer.m_outputs[writer.m_numOutputs++] = all.m_outputs[o];
+    }
+    if(writer.m_numOutputs == 0)
+        return LTC_OK;
+
+    LtcEmitItem item = { &layout, 0, 0, 0 };
+    err = ltcEmitItems(&item, 1, geometry->m_numVertices, allocator, config->m_taskInterface, &writer, NULL);
+    if(err != LTC_OK)
+        return err;
+
+    ltcPadVertexStreams(&writer, geometry->m_numVertices);
+    return LTC_OK;
+}
@@ -0,0 +1,112 @@
+#include <lattica/instance.h>
+#include <string.h>
+
+static void ltcSetScale(LtcInstanceTransform *transform, float x, float y, float z)
+{
+    memset(transform, 0, sizeof(*transform));
+    transform->m_matrix[0][0] = x;
+    transform->m_matrix[1][1] = y;
+    transform->m_matrix[2][2] = z;
+}
+
+LtcError_t ltcSplitInstanceTransform(LtcConfig *config, LtcInstanceTransform *outTransform)
+{
+    if(!config || !outTransform)
+        return LTC_ERR_INVALIDARGS;
+
+    /* only valid configs have positive dimensions to divide by */
+    LtcGeometrySize size;
+    LtcError_t err = ltcQueryGeometrySize(config, &size);
+    if(err != LTC_OK)
+        return err;
+
+    switch(config->m_shape)
+    {
+    case LTC_SHAPE_PLANE:
+    {
+        LtcConfigPlane *plane = (LtcConfigPlane *)config;
+        ltcSetScale(outTransform, plane->m_sizeX, plane->m_sizeY, 1.0f);
+        plane->m_sizeX = plane->m_sizeY = 1.0f;
+        break;
+    }
+    case LTC_SHAPE_CUBOID:
+    {
+        LtcConfigCuboid *cuboid = (LtcConfigCuboid *)config;
+        ltcSetScale(outTransform, cuboid->m_sizeX, cuboid->m_sizeY, cuboid->m_sizeZ);
+        cuboid->m_sizeX = cuboid->m_sizeY = cuboid->m_sizeZ = 1.0f;
+        break;
+    }
+    case LTC_SHAPE_SPHERE:
+    {
+        LtcConfigSphere *sphere = (LtcConfigSphere *)config;
+        ltcSetScale(outTransform, sphere->m_radius, sphere->m_radius, sphere->m_radius);
+        sphere->m_radius = 1.0f;
+        break;
+    }
+    case LTC_SHAPE_CYLINDER:
+    {
+        LtcConfigCylinder *cylinder = (LtcConfigCylinder *)config;
+        ltcSetScale(outTransform, cylinder->m_radius, cylinder->m_length, cylinder->m_radius);
+        cylinder->m_radius = cylinder->m_length = 1.0f;
+        break;
+    }
+    case LTC_SHAPE_CONE:
+    {
+        LtcConfigCone *cone = (LtcConfigCone *)config;
+        ltcSetScale(outTransform, cone->m_radius, cone->m_length, cone->m_radius);
+        cone->m_radius = cone->m_length = 1.0f;
+        break;
+    }
+    case LTC_SHAPE_PRISM:
+    {
+        LtcConfigPrism *prism = (LtcConfigPrism *)config;
+        ltcSetScale(outTransform, prism->m_radius, prism->m_length, prism->m_radius);
+        prism->m_radius = prism->m_length = 1.0f;
+        break;
+    }
+    case LTC_SHAPE_PYRAMID:
+    {
+        LtcConfigPyramid *pyramid = (LtcConfigPyramid *)config;
+        ltcSetScale(outTransform, pyramid->m_radius, pyramid->m_length, pyramid->m_radius);
+        pyramid->m_radius = pyramid->m_length = 1.0f;
+        break;
+    }
+    case LTC_SHAPE_TUBE:
+    {
+        LtcConfigTube *tube = (LtcConfigTube *)config;
+        ltcSetScale(outTransform, tube->m_outerRadius, tube->m_length, tube->m_outerRadius);
+        tube->m_innerRadius /= tube->m_outerRadius;
+        tube->m_outerRadius = tube->m_length = 1.0f;
+        break;
+    }
+    case LTC_SHAPE_CAPSULE:
+    {
+        LtcConfigCapsule *capsule = (LtcConfigCapsule *)config;
+        ltcSetScale(outTransform, capsule->m_radius, capsule->m_radius, capsule->m_radius);
+        capsule->m_cylinderLength /= capsule->m_radius;
+        capsule->m_radius = 1.0f;
+        break;
+    }
+    case LTC_SHAPE_TORUS:
+    {
+        LtcConfigTorus *torus = (LtcConfigTorus *)config;
+        ltcSetScale(outTransform, torus->m_majorRadius, torus->m_majorRadius, torus->m_majorRadius);
+        torus->m_minorRadius /= torus->m_majorRadius;
+        torus->m_majorRadius = 1.0f;
+        break;
+    }
+    case LTC_SHAPE_TORUSKNOT:
+    {
+        LtcConfigTorusKnot *knot = (LtcConfigTorusKnot *)config;
+        ltcSetScale(outTransform, knot->m_radius, knot->m_radius, knot->m_radius);
+        knot->m_torusRadius /= knot->m_radius;
+        knot->m_tubeRadius  /= knot->m_radius;
+        knot->m_radius = 1.0f;
+        break;
+    }
+    default:
+        return LTC_ERR_INVALIDARGS;
+    }
+
+    return LTC_OK;
+}
@@ -0,0 +1,159 @@
+#ifndef LATTICA_INTERNAL_H
+#define LATTICA_INTERNAL_H
+#include <lattica/generate.h>
+
+#define LTC_PI 3.14159265358979323846f
+
+#define LTC_MAX_PATCHES 6
+
+/* Every shape is emitted as a small set of parametric grid patches. A patch of
+ * divU x divV quads owns (divU + 1) * (divV + 1) vertices; rows that collapse
+ * to a single point (poles, apexes, cap centres) drop their degenerate
+ * triangles. Copies repeat the same grid, e.g. once per prism facet. */
+enum
+{
+    LTC_PATCH_COLLAPSE_V0 = 0x1,
+    LTC_PATCH_COLLAPSE_V1 = 0x2,
+    LTC_PATCH_FLIP        = 0x4,
+};
+
+typedef struct
+{
+    float m_position[3];
+    float m_normal[3];
+    float m_tangent[3];
+} LtcSurfacePoint;
+
+typedef struct LtcPatch LtcPatch;
+typedef struct LtcVertexWriter LtcVertexWriter;
+
+typedef void (*LtcPatchEvalFn)(const LtcPatch *patch, uint32_t copy, uint32_t i, uint32_t j, LtcSurfacePoint *out);
+/* Optional fast path writing vertex rows [rowBegin, rowEnd) of one patch copy
+ * at once, row rowBegin going to firstVertex; must produce the same vertices
+ * as m_eval and be safe to run for disjoint row ranges concurrently. */
+typedef void (*LtcPatchEmitFn)(const LtcPatch *patch, uint32_t copy, uint32_t rowBegin, uint32_t rowEnd,
+                               const LtcVertexWriter *writer, uint32_t firstVertex);
+
+struct LtcPatch
+{
+    LtcPatchEvalFn   m_eval;
+    LtcPatchEmitFn   m_emit;
+    const LtcConfig *m_config;
+    uint32_t         m_divU, m_divV;
+    uint32_t         m_count;
+    uint32_t         m_flags;
+    float            m_side;
+};
+
+typedef struct
+{
+    LtcPatch m_patches[LTC_MAX_PATCHES];
+    uint32_t m_numPatches;
+} LtcLayout;
+
+/* Output pointers for the enabled attributes, resolved once per call so the
+ * per-vertex path is a straight copy with no lookups. */
+typedef struct
+{
+    uint8_t                *m_buffer;
+    size_t                  m_stride;
+    size_t                  m_componentStride;
+    uint32_t                m_slot;
+    uint32_t                m_numComponents;   /* before packing */
+    uint32_t                m_numStored;
+    uint32_t                m_componentSize;
+    LtcVertexAttribFormat_t m_format;
+    int                     m_streamed;
+} LtcAttribOutput;
+
+struct LtcVertexWriter
+{
+    LtcAttribOutput m_outputs[LTC_VERTEX_ATTRIB_COUNT];
+    uint32_t        m_numOutputs;
+};
+
+const LtcAllocator *ltcGetAllocator(const LtcConfig *config);
+LtcError_t ltcValidateAllocator(const LtcAllocator *allocator);
+
+/* Validates config and describes it as patches. */
+LtcError_t ltcBuildLayout(const LtcConfig *config, LtcLayout *layout);
+uint32_t ltcPatchVertexCount(const LtcPatch *patch);
+uint32_t ltcPatchIndexCount(const LtcPatch *patch);
+LtcError_t ltcLayoutSize(const LtcLayout *layout, LtcGeometrySize *outSize);
+
+/* The vertex count an index size has to cover for numVertices vertices: one
+ * more with strips, whose restart index takes the largest value. */
+uint32_t ltcIndexRange(LtcIndexTopology_t topology, uint32_t numVertices);
+/* numVertices is the largest vertex count any index has to address, as from
+ * ltcIndexRange. */
+LtcError_t ltcValidateBuffers(const LtcGeometry *geometry, uint32_t numVertices);
+/* Sets geometry->m_indexSize for an index range of numVertices vertices,
+ * resolving LTC_INDEX_SIZE_AUTO. Needed before allocating. */
+void ltcResolveIndexSize(LtcGeometry *geometry, uint32_t numVertices);
+LtcError_t ltcAllocateBuffers(const LtcAllocator *allocator, LtcGeometry *geometry, const LtcGeometrySize *size);
+/* The attached index buffer as written, i.e. with the resolved index size,
+ * or NULL without one. */
+const LtcIndexBuffer *ltcGetWrittenIndices(const LtcGeometry *geometry, LtcIndexBuffer *scratch);
+void ltcInitVertexWriter(const LtcGeometry *geometry, LtcVertexWriter *writer);
+void ltcPadVertexStreams(const LtcVertexWriter *writer, uint32_t numVertices);
+uint32_t ltcReadIndex(const LtcIndexBuffer *indices, uint32_t at);
+void ltcWriteIndex(const LtcIndexBuffer *indices, uint32_t at, uint32_t index);
+
+/* Whether the patch's triangles are written clockwise in its (u, v) grid. */
+int ltcPatchFlipWinding(const LtcPatch *patch);
+/* The triangles written for a quad in row j as corners 0 (i, j), 1 (i + 1, j),
+ * 2 (i + 1, j + 1) and 3 (i, j + 1); returns how many (0 to 2). Matches the
+ * index buffer triangulation. */
+uint32_t ltcQuadTriangles(const LtcPatch *patch, uint32_t j, int flipWinding, uint8_t corners[6]);
+
+/* Indices written for quad rows [rowBegin, rowEnd) of one patch copy. */
+uint32_t ltcQuadRowsIndexCount(const LtcPatch *patch, uint32_t rowBegin, uint32_t rowEnd);
+
+/* Vertex rows [m_rowBegin, m_rowEnd) of one patch copy, stored from
+ * m_firstVertex on, and the quads of rows [m_rowBegin, m_quadEnd), stored from
+ * m_firstIndex on. Index values are relative to m_indexBase. */
+typedef struct
+{
+    const LtcPatch *m_patch;
+    uint32_t        m_copy;
+    uint32_t        m_rowBegin, m_rowEnd, m_quadEnd;
+    uint32_t        m_firstVertex;
+    uint32_t        m_firstIndex;
+    uint32_t        m_indexBase;
+} LtcEmitPiece;
+
+void ltcEmitPiece(const LtcEmitPiece *piece, const LtcVertexWriter *writer, const LtcIndexBuffer *indices);
+
+/* Roughly how many vertices one task writes. Patch copies larger than this
+ * are split into row ranges, smaller ones are grouped. */
+#define LTC_TASK_VERTICES 8192
+
+/* Emits all pieces, grouped into tasks on taskInterface (may be NULL) when
+ * there is enough work (numVertices in total). Output does not depend on how
+ * the tasks are scheduled. */
+LtcError_t ltcEmitPieces(const LtcEmitPiece *pieces, uint32_t numPieces, uint32_t numVertices, const LtcAllocator *allocator,
+                         const LtcTaskInterface *taskInterface, const LtcVertexWriter *writer, const LtcIndexBuffer *indices);
+
+/* One layout to emit and where its vertices and indices go. */
+typedef struct
+{
+    const LtcLayout *m_layout;
+    uint32_t         m_firstVertex;
+    uint32_t         m_firstIndex;
+    uint32_t         m_indexBase;
+} LtcEmitItem;
+
+/* Emits every item like ltcEmitPieces, cutting large patch copies into row
+ * ranges so they spread over the tasks. */
+LtcError_t ltcEmitItems(const LtcEmitItem *items, uint32_t count, uint32_t numVertices, const LtcAllocator *allocator,
+                        const LtcTaskInterface *taskInterface, const LtcVertexWriter *writer, const LtcIndexBuffer *indices);
+
+/* Runs the optimisations selected by LtcConfigFlags_t on one generated mesh:
+ * indices [firstIndex, firstIndex + numIndices) with values in [indexBase,
+ * indexBase + numVertices), referring to the vertices stored from
+ * firstVertex on. Stream padding is left to the caller. */
+LtcError_t ltcOptimizeRange(const LtcAllocator *allocator, uint32_t flags, const LtcVertexWriter *writer,
+                            const LtcIndexBuffer *indices, uint32_t firstIndex, uint32_t numIndices,
+                            uint32_t indexBase, uint32_t firstVertex, uint32_t numVertices);
+
+#endif /* LATTICA_INTERNAL_H */
@@ -0,0 +1,308 @@
+#include <lattica/lod.h>
+#include "internal.h"
+#include <math.h>
+
+typedef union
+{
+    LtcConfig          m_common;
+    LtcConfigPlane     m_plane;
+    LtcConfigCuboid    m_cuboid;
+    LtcConfigSphere    m_sphere;
+    LtcConfigCylinder  m_cylinder;
+    LtcConfigCone      m_cone;
+    LtcConfigPrism     m_prism;
+    LtcConfigPyramid   m_pyramid;
+    LtcConfigTube      m_tube;
+    LtcConfigCapsule   m_capsule;
+    LtcConfigTorus     m_torus;
+    LtcConfigTorusKnot m_torusKnot;
+} LtcAnyConfig;
+
+/* Distance of the midpoint of a chord spanning angle from the arc. */
+static float ltcSagitta(float radius, float angle)
+{
+    return radius * (1.0f - cosf(0.5f * angle));
+}
+
+/* Bound for a sphere section tessellated in steps of the two angles: the
+ * corners of every quad lie within a cap around its centre whose base plane
+ * the quad cannot cross. */
+static float ltcSphereError(float radius, float longitudeStep, float latitudeStep)
+{
+    return ltcSagitta(radius, longitudeStep) + ltcSagitta(radius, latitudeStep);
+}
+
+/* The torus knot's centre line error is this times the squared parameter
+ * step: a chord over dt leaves the line by at most dt^2 / 8 times its largest
+ * curvature term, and the tube's frame turns at about that term over the
+ * slowest speed, which swings the tube surface further out. */
+static float ltcTorusKnotCurveFactor(const LtcConfigTorusKnot *knot)
+{
+    float p = fabsf((float)knot->m_p);
+    float q = fabsf((float)knot->m_q);
+    float a = knot->m_torusRadius;
+    float inner = knot->m_radius > a ? knot->m_radius - a : 0.0f;
+
+    float curve = p * p * (knot->m_radius + a) + 2.0f * p * q * a + q * q * a;
+    float speed = sqrtf(p * p * inner * inner + q * q * a * a);
+    float turn = curve / speed;
+    return 0.125f * (curve + knot->m_tubeRadius * turn * turn);
+}
+
+static float ltcTorusKnotError(const LtcConfigTorusKnot *knot)
+{
+    float dt = 2.0f * LTC_PI / (float)knot->m_divTubular;
+    return dt * dt * ltcTorusKnotCurveFactor(knot) +
+           ltcSagitta(knot->m_tubeRadius, 2.0f * LTC_PI / (float)knot->m_divRadial);
+}
+
+LtcError_t ltcQueryGeometryError(const LtcConfig *config, float *outError)
+{
+    if(!config || !outError)
+        return LTC_ERR_INVALIDARGS;
+
+    LtcLayout layout;
+    LtcError_t err = ltcBuildLayout(config, &layout);
+    if(err != LTC_OK)
+        return err;
+
+    const LtcAnyConfig *any = (const LtcAnyConfig *)config;
+    switch(config->m_shape)
+    {
+    case LTC_SHAPE_PLANE:
+    case LTC_SHAPE_CUBOID:
+    case LTC_SHAPE_PRISM:
+    case LTC_SHAPE_PYRAMID:
+        *outError = 0.0f;
+        break;
+    case LTC_SHAPE_SPHERE:
+        *outError = ltcSphereError(any->m_sphere.m_radius, 2.0f * LTC_PI / (float)any->m_sphere.m_divLongitude,
+                                   LTC_PI / (float)any->m_sphere.m_divLatitude);
+        break;
+    case LTC_SHAPE_CYLINDER:
+        *outError = ltcSagitta(any->m_cylinder.m_radius, 2.0f * LTC_PI / (float)any->m_cylinder.m_divRadial);
+        break;
+    case LTC_SHAPE_CONE:
+        *outError = ltcSagitta(any->m_cone.m_radius, 2.0f * LTC_PI / (float)any->m_cone.m_divRadial);
+        break;
+    case LTC_SHAPE_TUBE:
+        *outError = ltcSagitta(any->m_tube.m_outerRadius, 2.0f * LTC_PI / (float)any->m_tube.m_divRadial);
+        break;
+    case LTC_SHAPE_CAPSULE:
+        *outError = ltcSphereError(any->m_capsule.m_radius, 2.0f * LTC_PI / (float)any->m_capsule.m_divRadial,
+                                   0.5f * LTC_PI / (float)any->m_capsule.m_divLatitude);
+        break;
+    case LTC_SHAPE_TORUS:
+        *outError = ltcSagitta(any->m_torus.m_majorRadius + any->m_torus.m_minorRadius,
+                               2.0f * LTC_PI / (float)any->m_torus.m_divRadialMajor) +
+                    ltcSagitta(any->m_torus.m_minorRadius, 2.0f * LTC_PI / (float)any->m_torus.m_divRadialMinor);
+        break;
+    case LTC_SHAPE_TORUSKNOT:
+        *outError = ltcTorusKnotError(&any->m_torusKnot);
+        break;
+    default:
+        return LTC_ERR_INVALIDARGS;
+    }
+    return LTC_OK;
+}
+
+/* Fewest segments for an arc of the given angle whose chords stay within
+ * tolerance of it. */
+static uint16_t ltcArcDivisions(float radius, float arc, float tolerance, uint16_t minimum)
+{
+    double step = tolerance < radius ? 2.0 * acos(1.0 - (double)tolerance / radius) : LTC_PI;
+    double divisions = ceil(arc / step);
+    if(divisions >= 65535.0)
+        return 65535;
+    uint16_t n = divisions > minimum ? (uint16_t)divisions : minimum;
+    while(n < 65535 && ltcSagitta(radius, arc / (float)n) > tolerance)
+        ++n;
+    return n;
+}
+
+LtcError_t ltcSelectDivisions(LtcConfig *config, float sizePixels, float maxErrorPixels)
+{
+    if(!config || !(sizePixels > 0.0f) || !(maxErrorPixels > 0.0f))
+        return LTC_ERR_INVALIDARGS;
+
+    LtcBounds bounds;
+    LtcError_t err = ltcQueryGeometryBounds(config, &bounds);
+    if(err != LTC_OK)
+        return err;
+
+    float tolerance = maxErrorPixels * 2.0f * bounds.m_radius / sizePixels;
+    float half = 0.5f * tolerance;
+    LtcAnyConfig *any = (LtcAnyConfig *)config;
+    switch(config->m_shape)
+    {
+    case LTC_SHAPE_SPHERE:
+        any->m_sphere.m_divLongitude = ltcArcDivisions(any->m_sphere.m_radius, 2.0f * LTC_PI, half, 3);
+        any->m_sphere.m_divLatitude  = ltcArcDivisions(any->m_sphere.m_radius, LTC_PI, half, 2);
+        break;
+    case LTC_SHAPE_CYLINDER:
+        any->m_cylinder.m_divRadial = ltcArcDivisions(any->m_cylinder.m_radius, 2.0f * LTC_PI, tolerance, 3);
+        break;
+    case LTC_SHAPE_CONE:
+        any->m_cone.m_divRadial = ltcArcDivisions(any->m_cone.m_radius, 2.0f * LTC_PI, tolerance, 3);
+        break;
+    case LTC_SHAPE_TUBE:
+        any->m_tube.m_divRadial = ltcArcDivisions(any->m_tube.m_outerRadius, 2.0f * LTC_PI, tolerance, 3);
+        break;
+    case LTC_SHAPE_CAPSULE:
+        any->m_capsule.m_divRadial   = ltcArcDivisions(any->m_capsule.m_radius, 2.0f * LTC_PI, half, 3);
+        any->m_capsule.m_divLatitude = ltcArcDivisions(any->m_capsule.m_radius, 0.5f * LTC_PI, half, 1);
+        break;
+    case LTC_SHAPE_TORUS:
+        any->m_torus.m_divRadialMajor = ltcArcDivisions(any->m_torus.m_majorRadius + any->m_torus.m_minorRadius,
+                                                        2.0f * LTC_PI, half, 3);
+        any->m_torus.m_divRadialMinor = ltcArcDivisions(any->m_torus.m_minorRadius, 2.0f * LTC_PI, half, 3);
+        break;
+    case LTC_SHAPE_TORUSKNOT:
+    {
+        LtcConfigTorusKnot *knot = &any->m_torusKnot;
+        double divisions = ceil(2.0 * LTC_PI * sqrt(ltcTorusKnotCurveFactor(knot) / (double)half));
+        knot->m_divRadial  = ltcArcDivisions(knot->m_tubeRadius, 2.0f * LTC_PI, half, 3);
+        knot->m_divTubular = divisions >= 65535.0 ? 65535 : divisions > 3.0 ? (uint16_t)divisions : 3;
+        break;
+    }
+    default:
+        break;
+    }
+    return LTC_OK;
+}
+
+static uint16_t ltcScaleDivisions(uint16_t divisions, float scale, uint16_t minimum)
+{
+    float scaled = (float)divisions * scale + 0.5f;
+    return scaled > (float)minimum ? (uint16_t)scaled : minimum;
+}
+
+/* Copies config with its division counts scaled, keeping the minimums
+ * ltcBuildLayout accepts. config must have passed it already. */
+static void ltcScaleConfig(const LtcConfig *config, float scale, LtcAnyConfig *out)
+{
+    const LtcAnyConfig *in = (const LtcAnyConfig *)config;
+    switch(config->m_shape)
+    {
+    case LTC_SHAPE_PLANE:
+        out->m_plane = in->m_plane;
+        out->m_plane.m_divX = ltcScaleDivisions(in->m_plane.m_divX, scale, 1);
+        out->m_plane.m_divY = ltcScaleDivisions(in->m_plane.m_divY, scale, 1);
+        break;
+    case LTC_SHAPE_CUBOID:
+        out->m_cuboid = in->m_cuboid;
+        out->m_cuboid.m_divX = ltcScaleDivisions(in->m_cuboid.m_divX, scale, 1);
+        out->m_cuboid.m_divY = ltcScaleDivisions(in->m_cuboid.m_divY, scale, 1);
+        out->m_cuboid.m_divZ = ltcScaleDivisions(in->m_cuboid.m_divZ, scale, 1);
+        break;
+    case LTC_SHAPE_SPHERE:
+        out->m_sphere = in->m_sphere;
+        out->m_sphere.m_divLongitude = ltcScaleDivisions(in->m_sphere.m_divLongitude, scale, 3);
+        out->m_sphere.m_divLatitude  = ltcScaleDivisions(in->m_sphere.m_divLatitude, scale, 2);
+        break;
+    case LTC_SHAPE_CYLINDER:
+        out->m_cylinder = in->m_cylinder;
+        out->m_cylinder.m_divRadial = ltcScaleDivisions(in->m_cylinder.m_divRadial, scale, 3);
+        out->m_cylinder.m_divAxial  = ltcScaleDivisions(in->m_cylinder.m_divAxial, scale, 1);
+        out->m_cylinder.m_divRings  = ltcScaleDivisions(in->m_cylinder.m_divRings, scale, 1);
+        break;
+    case LTC_SHAPE_CONE:
+        out->m_cone = in->m_cone;
+        out->m_cone.m_divRadial = ltcScaleDivisions(in->m_cone.m_divRadial, scale, 3);
+        out->m_cone.m_divAxial  = ltcScaleDivisions(in->m_cone.m_divAxial, scale, 1);
+        out->m_cone.m_divRings  = ltcScaleDivisions(in->m_cone.m_divRings, scale, 1);
+        break;
+    case LTC_SHAPE_PRISM:
+        out->m_prism = in->m_prism;
+        out->m_prism.m_divPerFacetRadial = ltcScaleDivisions(in->m_prism.m_divPerFacetRadial, scale, 1);
+        out->m_prism.m_divAxial          = ltcScaleDivisions(in->m_prism.m_divAxial, scale, 1);
+        out->m_prism.m_divRings          = ltcScaleDivisions(in->m_prism.m_divRings, scale, 1);
+        break;
+    case LTC_SHAPE_PYRAMID:
+        out->m_pyramid = in->m_pyramid;
+        out->m_pyramid.m_divPerFacetRadial = ltcScaleDivisions(in->m_pyramid.m_divPerFacetRadial, scale, 1);
+        out->m_pyramid.m_divAxial          = ltcScaleDivisions(in->m_pyramid.m_divAxial, scale, 1);
+        out->m_pyramid.m_divRings          = ltcScaleDivisions(in->m_pyramid.m_divRings, scale, 1);
+        break;
+    case LTC_SHAPE_TUBE:
+        out->m_tube = in->m_tube;
+        out->m_tube.m_divRadial = ltcScaleDivisions(in->m_tube.m_divRadial, scale, 3);
+        out->m_tube.m_divAxial  = ltcScaleDivisions(in->m_tube.m_divAxial, scale, 1);
+        out->m_tube.m_divRings  = ltcScaleDivisions(in->m_tube.m_divRings, scale, 1);
+        break;
+    case LTC_SHAPE_CAPSULE:
+        out->m_capsule = in->m_capsule;
+        out->m_capsule.m_divRadial   = ltcScaleDivisions(in->m_capsule.m_divRadial, scale, 3);
+        out->m_capsule.m_divAxial    = ltcScaleDivisions(in->m_capsule.m_divAxial, scale, 1);
+        out->m_capsule.m_divLatitude = ltcScaleDivisions(in->m_capsule.m_divLatitude, scale, 1);
+        break;
+    case LTC_SHAPE_TORUS:
+        out->m_torus = in->m_torus;
+        out->m_torus.m_divRadialMinor = ltcScaleDivisions(in->m_torus.m_divRadialMinor, scale, 3);
+        out->m_torus.m_divRadialMajor = ltcScaleDivisions(in->m_torus.m_divRadialMajor, scale, 3);
+        break;
+    default:
+        out->m_torusKnot = in->m_torusKnot;
+        out->m_torusKnot.m_divRadial  = ltcScaleDivisions(in->m_torusKnot.m_divRadial, scale, 3);
+        out->m_torusKnot.m_divTubular = ltcScaleDivisions(in->m_torusKnot.m_divTubular, scale, 3);
+        break;
+    }
+}
+
+static LtcError_t ltcBuildLodConfigs(const LtcConfig *config, uint32_t numLods, float reduction,
+                                     LtcAnyConfig *outConfigs, const LtcConfig **outPointers)
+{
+    if(!config || numLods < 1 || numLods > LTC_MAX_LODS || !(reduction > 0.0f && reduction <= 1.0f))
+        return LTC_ERR_INVALIDARGS;
+
+    LtcLayout layout;
+    LtcError_t err = ltcBuildLayout(config, &layout);
+    if(err != LTC_OK)
+        return err;
+
+    float scale = 1.0f;
+    for(uint32_t l = 0; l < numLods; ++l, scale *= reduction)
+    {
+        ltcScaleConfig(config, scale, &outConfigs[l]);
+        outPointers[l] = &outConfigs[l].m_common;
+    }
+    return LTC_OK;
+}
+
+LtcError_t ltcQueryLodChainSize(const LtcConfig *config, uint32_t numLods, float reduction, LtcGeometrySize *outSize)
+{
+    LtcAnyConfig lods[LTC_MAX_LODS];
+    const LtcConfig *pointers[LTC_MAX_LODS];
+    if(!outSize)
+        return LTC_ERR_INVALIDARGS;
+
+    LtcError_t err = ltcBuildLodConfigs(config, numLods, reduction, lods, pointers);
+    if(err != LTC_OK)
+        return err;
+    return ltcQueryGeometryBatchSize(pointers, numLods, outSize);
+}
+
+LtcError_t ltcGenerateLodChain(const LtcConfig *config, uint32_t numLods, float reduction, uint32_t flags,
+                               LtcLod *outLods, LtcGeometry *outGeometry)
+{
+    LtcAnyConfig lods[LTC_MAX_LODS];
+    const LtcConfig *pointers[LTC_MAX_LODS];
+    LtcBatchItem items[LTC_MAX_LODS];
+    if(!outLods || !outGeometry)
+        return LTC_ERR_INVALIDARGS;
+
+    LtcError_t err = ltcBuildLodConfigs(config, numLods, reduction, lods, pointers);
+    if(err != LTC_OK)
+        return err;
+
+    err = ltcGenerateGeometryBatch(pointers, numLods, flags, items, outGeometry);
+    for(uint32_t l = 0; l < numLods && err == LTC_OK; ++l)
+    {
+        outLods[l].m_firstVertex = items[l].m_firstVertex;
+        outLods[l].m_numVertices = items[l].m_numVertices;
+        outLods[l].m_firstIndex  = items[l].m_firstIndex;
+        outLods[l].m_numIndices  = items[l].m_numIndices;
+        err = ltcQueryGeometryError(pointers[l], &outLods[l].m_error);
+    }
+    return err;
+}
@@ -0,0 +1,290 @@
+#include <lattica/meshlet.h>
+#include "internal.h"
+#include <math.h>
+#include <string.h>
+
+#define LTC_NO_LOCAL_VERTEX 0xFFFFu
+
+void ltcInitDefaultMeshletLimits(LtcMeshletLimits *limits)
+{
+    limits->m_maxVertices  = 64;
+    limits->m_maxTriangles = 124;
+}
+
+static LtcError_t ltcValidateMeshletLimits(const LtcMeshletLimits *limits)
+{
+    if(!limits || limits->m_maxVertices < 4 || limits->m_maxVertices > LTC_MESHLET_MAX_VERTICES ||
+       limits->m_maxTriangles < 2 || limits->m_maxTriangles > LTC_MESHLET_MAX_TRIANGLES)
+        return LTC_ERR_INVALIDARGS;
+    return LTC_OK;
+}
+
+/* Largest tile of quads within the limits, the squarest of equal ones since
+ * that gives the tightest bounds. */
+static void ltcChooseTile(const LtcPatch *patch, const LtcMeshletLimits *limits, uint32_t *outTileU, uint32_t *outTileV)
+{
+    uint32_t bestU = 1, bestV = 1;
+    for(uint32_t tileU = 1; tileU <= patch->m_divU && tileU + 1 <= limits->m_maxVertices / 2; ++tileU)
+    {
+        uint32_t tileV = limits->m_maxVertices / (tileU + 1) - 1;
+        if(tileV > limits->m_maxTriangles / (2 * tileU))
+            tileV = limits->m_maxTriangles / (2 * tileU);
+        if(tileV > patch->m_divV)
+            tileV = patch->m_divV;
+        if(tileV == 0)
+            break;
+
+        uint32_t quads = tileU * tileV, bestQuads = bestU * bestV;
+        uint32_t skew = tileU > tileV ? tileU - tileV : tileV - tileU;
+        uint32_t bestSkew = bestU > bestV ? bestU - bestV : bestV - bestU;
+        if(quads > bestQuads || (quads == bestQuads && skew < bestSkew))
+        {
+            bestU = tileU;
+            bestV = tileV;
+        }
+    }
+    *outTileU = bestU;
+    *outTileV = bestV;
+}
+
+static void ltcSub3(const float *a, const float *b, float *out)
+{
+    out[0] = a[0] - b[0];
+    out[1] = a[1] - b[1];
+    out[2] = a[2] - b[2];
+}
+
+static float ltcDot3(const float *a, const float *b)
+{
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+/* Unit front face normal, or 0 for a degenerate triangle. */
+static int ltcFaceNormal(const float (*positions)[3], const uint8_t *triangle, float sign, float *out)
+{
+    float e1[3], e2[3];
+    ltcSub3(positions[triangle[1]], positions[triangle[0]], e1);
+    ltcSub3(positions[triangle[2]], positions[triangle[0]], e2);
+    out[0] = (e1[1] * e2[2] - e1[2] * e2[1]) * sign;
+    out[1] = (e1[2] * e2[0] - e1[0] * e2[2]) * sign;
+    out[2] = (e1[0] * e2[1] - e1[1] * e2[0]) * sign;
+
+    float len = sqrtf(ltcDot3(out, out));
+    if(len == 0.0f)
+        return 0;
+    out[0] /= len;
+    out[1] /= len;
+    out[2] /= len;
+    return 1;
+}
+
+static void ltcComputeMeshletBounds(LtcMeshlet *meshlet, const float (*positions)[3], const uint8_t *triangles, float sign)
+{
+    float lo[3], hi[3];
+    memcpy(lo, positions[0], sizeof(lo));
+    memcpy(hi, positions[0], sizeof(hi));
+    for(uint32_t v = 1; v < meshlet->m_numVertices; ++v)
+    {
+        for(uint32_t k = 0; k < 3; ++k)
+        {
+            lo[k] = positions[v][k] < lo[k] ? positions[v][k] : lo[k];
+            hi[k] = positions[v][k] > hi[k] ? positions[v][k] : hi[k];
+        }
+    }
+
+    float *center = meshlet->m_center;
+    float radius2 = 0.0f;
+    for(uint32_t k = 0; k < 3; ++k)
+        center[k] = 0.5f * (lo[k] + hi[k]);
+    for(uint32_t v = 0; v < meshlet->m_numVertices; ++v)
+    {
+        float d[3];
+        ltcSub3(positions[v], center, d);
+        radius2 = ltcDot3(d, d) > radius2 ? ltcDot3(d, d) : radius2;
+    }
+    meshlet->m_radius = sqrtf(radius2);
+
+    float *axis = meshlet->m_coneAxis;
+    float normal[3];
+    axis[0] = axis[1] = axis[2] = 0.0f;
+    for(uint32_t t = 0; t < meshlet->m_numTriangles; ++t)
+    {
+        if(!ltcFaceNormal(positions, &triangles[3 * t], sign, normal))
+            continue;
+        axis[0] += normal[0];
+        axis[1] += normal[1];
+        axis[2] += normal[2];
+    }
+
+    float len = sqrtf(ltcDot3(axis, axis));
+    float minDot = 1.0f;
+    if(len > 0.0f)
+    {
+        axis[0] /= len;
+        axis[1] /= len;
+        axis[2] /= len;
+        for(uint32_t t = 0; t < meshlet->m_numTriangles; ++t)
+        {
+            if(ltcFaceNormal(positions, &triangles[3 * t], sign, normal) && ltcDot3(normal, axis) < minDot)
+                minDot = ltcDot3(normal, axis);
+        }
+    }
+
+    /* cones wider than about a hemisphere never cull anything */
+    memcpy(meshlet->m_coneApex, center, sizeof(meshlet->m_coneApex));
+    if(len == 0.0f || minDot <= 0.1f)
+    {
+        meshlet->m_coneCutoff = 1.0f;
+        return;
+    }
+
+    /* pull the apex back along the axis until every triangle plane is in
+     * front of it */
+    float maxT = 0.0f;
+    for(uint32_t t = 0; t < meshlet->m_numTriangles; ++t)
+    {
+        const uint8_t *triangle = &triangles[3 * t];
+        if(!ltcFaceNormal(positions, triangle, sign, normal))
+            continue;
+        float d[3];
+        ltcSub3(center, positions[triangle[0]], d);
+        float dist = ltcDot3(d, normal) / ltcDot3(axis, normal);
+        maxT = dist > maxT ? dist : maxT;
+    }
+    for(uint32_t k = 0; k < 3; ++k)
+        meshlet->m_coneApex[k] = center[k] - axis[k] * maxT;
+    meshlet->m_coneCutoff = sqrtf(1.0f - minDot * minDot);
+}
+
+/* Tiles every copy of every patch and counts the meshlets. With out set the
+ * meshlets are written too; positions are then evaluated for the bounds. */
+static void ltcBuildMeshlets(const LtcLayout *layout, const LtcMeshletLimits *limits, const LtcMeshletBuffers *out,
+                             LtcMeshletCounts *counts)
+{
+    uint16_t local[LTC_MESHLET_MAX_VERTICES];
+    float positions[LTC_MESHLET_MAX_VERTICES][3];
+    uint32_t firstVertex = 0;
+
+    counts->m_numMeshlets  = 0;
+    counts->m_numVertices  = 0;
+    counts->m_numTriangles = 0;
+
+    for(uint32_t p = 0; p < layout->m_numPatches; ++p)
+    {
+        const LtcPatch *patch = &layout->m_patches[p];
+        int flipWinding = ltcPatchFlipWinding(patch);
+        float sign = patch->m_config->m_windingOrder == LTC_WINDING_ORDER_CLOCKWISE ? -1.0f : 1.0f;
+        uint32_t rowSize = patch->m_divU + 1;
+
+        uint32_t tileU, tileV;
+        ltcChooseTile(patch, limits, &tileU, &tileV);
+        uint32_t numTilesU = (patch->m_divU + tileU - 1) / tileU;
+        uint32_t numTilesV = (patch->m_divV + tileV - 1) / tileV;
+
+        for(uint32_t copy = 0; copy < patch->m_count; ++copy, firstVertex += ltcPatchVertexCount(patch))
+        {
+            for(uint32_t tv = 0; tv < numTilesV; ++tv)
+            {
+                uint32_t j0 = patch->m_divV * tv / numTilesV;
+                uint32_t j1 = patch->m_divV * (tv + 1) / numTilesV;
+                for(uint32_t tu = 0; tu < numTilesU; ++tu)
+                {
+                    uint32_t i0 = patch->m_divU * tu / numTilesU;
+                    uint32_t i1 = patch->m_divU * (tu + 1) / numTilesU;
+                    uint32_t width = i1 - i0 + 1;
+                    memset(local, 0xFF, (size_t)width * (j1 - j0 + 1) * sizeof(uint16_t));
+
+                    LtcMeshlet *meshlet = out ? &out->m_meshlets[counts->m_numMeshlets] : NULL;
+                    uint32_t *vertices  = out ? &out->m_vertices[counts->m_numVertices] : NULL;
+                    uint8_t *triangles  = out ? &out->m_triangles[3 * counts->m_numTriangles] : NULL;
+                    uint32_t numVertices = 0, numTriangles = 0;
+
+                    for(uint32_t j = j0; j < j1; ++j)
+                    {
+                        uint8_t corners[6];
+                        uint32_t quadTriangles = ltcQuadTriangles(patch, j, flipWinding, corners);
+                        for(uint32_t i = i0; i < i1; ++i)
+                        {
+                            for(uint32_t c = 0; c < 3 * quadTriangles; ++c)
+                            {
+                                uint32_t ci = i + (corners[c] == 1 || corners[c] == 2);
+                                uint32_t cj = j + (corners[c] >= 2);
+                                uint16_t *slot = &local[(cj - j0) * width + (ci - i0)];
+                                if(*slot == LTC_NO_LOCAL_VERTEX)
+                                {
+                                    if(out)
+                                    {
+                                        LtcSurfacePoint point;
+                                        patch->m_eval(patch, copy, ci, cj, &point);
+                                        memcpy(positions[numVertices], point.m_position, sizeof(positions[0]));
+                                        vertices[numVertices] = firstVertex + cj * rowSize + ci;
+                                    }
+                                    *slot = (uint16_t)numVertices++;
+                                }
+                                if(out)
+                                    triangles[3 * numTriangles + c % 3] = (uint8_t)*slot;
+                                if(c % 3 == 2)
+                                    ++numTriangles;
+                            }
+                        }
+                    }
+                    if(numTriangles == 0)
+                        continue;
+
+                    if(out)
+                    {
+                        meshlet->m_vertexOffset   = counts->m_numVertices;
+                        meshlet->m_triangleOffset = 3 * counts->m_numTriangles;
+                        meshlet->m_numVertices    = numVertices;
+                        meshlet->m_numTriangles   = numTriangles;
+                        ltcComputeMeshletBounds(meshlet, (const float (*)[3])positions, triangles, sign);
+                    }
+                    ++counts->m_numMeshlets;
+                    counts->m_numVertices  += numVertices;
+                    counts->m_numTriangles += numTriangles;
+                }
+            }
+        }
+    }
+}
+
+LtcError_t ltcQueryGeometryMeshlets(const LtcConfig *config, const LtcMeshletLimits *limits, LtcMeshletCounts *outCounts)
+{
+    if(!config || !outCounts || ltcValidateMeshletLimits(limits) != LTC_OK)
+        return LTC_ERR_INVALIDARGS;
+
+    LtcLayout layout;
+    LtcError_t err = ltcBuildLayout(config, &layout);
+    if(err != LTC_OK)
+        return err;
+
+    LtcGeometrySize size;
+    err = ltcLayoutSize(&layout, &size);
+    if(err != LTC_OK)
+        return err;
+
+    ltcBuildMeshlets(&layout, limits, NULL, outCounts);
+    return LTC_OK;
+}
+
+LtcError_t ltcGenerateGeometryMeshlets(const LtcConfig *config, const LtcMeshletLimits *limits,
+                                       const LtcMeshletBuffers *outMeshlets, LtcGeometry *outGeometry)
+{
+    if(!config || !outMeshlets || !outMeshlets->m_meshlets || !outMeshlets->m_vertices || !outMeshlets->m_triangles ||
+       !outGeometry || ltcValidateMeshletLimits(limits) != LTC_OK ||
+       (config->m_flags & LTC_CONFIG_FLAG_OPTIMIZE_VERTEX_FETCH))
+        return LTC_ERR_INVALIDARGS;
+
+    LtcLayout layout;
+    LtcError_t err = ltcBuildLayout(config, &layout);
+    if(err != LTC_OK)
+        return err;
+
+    err = ltcGenerateGeometry(config, outGeometry);
+    if(err != LTC_OK)
+        return err;
+
+    LtcMeshletCounts counts;
+    ltcBuildMeshlets(&layout, limits, outMeshlets, &counts);
+    return LTC_OK;
+}
@@ -0,0 +1,351 @@
+#include <lattica/optimize.h>
+#include "internal.h"
+#include <math.h>
+#include <string.h>
+
+/* Forsyth, "Linear-Speed Vertex Cache Optimisation" (2006). The three
+ * vertices of the last triangle score the same so it does not matter which
+ * one comes first; vertices with few triangles left are boosted so no lone
+ * triangles are stranded. The cache holds 3 extra entries so vertices just
+ * pushed out still get their score lowered. */
+#define LTC_LAST_TRIANGLE_SCORE 0.75f
+#define LTC_CACHE_DECAY_POWER   1.5f
+#define LTC_VALENCE_BOOST_SCALE 2.0f
+#define LTC_VALENCE_BOOST_POWER 0.5f
+#define LTC_MAX_VALENCE_TABLE   32
+
+typedef struct
+{
+    float m_cache[LTC_VERTEX_CACHE_SIZE];
+    float m_valence[LTC_MAX_VALENCE_TABLE];
+} LtcScoreTables;
+
+static void ltcInitScoreTables(LtcScoreTables *tables)
+{
+    for(uint32_t i = 0; i < LTC_VERTEX_CACHE_SIZE; ++i)
+    {
+        if(i < 3)
+            tables->m_cache[i] = LTC_LAST_TRIANGLE_SCORE;
+        else
+            tables->m_cache[i] = powf(1.0f - (float)(i - 3) / (LTC_VERTEX_CACHE_SIZE - 3), LTC_CACHE_DECAY_POWER);
+    }
+    tables->m_valence[0] = 0.0f;
+    for(uint32_t i = 1; i < LTC_MAX_VALENCE_TABLE; ++i)
+        tables->m_valence[i] = LTC_VALENCE_BOOST_SCALE * powf((float)i, -LTC_VALENCE_BOOST_POWER);
+}
+
+static float ltcVertexScore(const LtcScoreTables *tables, int32_t cachePos, uint32_t liveTriangles)
+{
+    if(liveTriangles == 0)
+        return -1.0f;
+
+    float score = cachePos >= 0 ? tables->m_cache[cachePos] : 0.0f;
+    if(liveTriangles < LTC_MAX_VALENCE_TABLE)
+        return score + tables->m_valence[liveTriangles];
+    return score + LTC_VALENCE_BOOST_SCALE * powf((float)liveTriangles, -LTC_VALENCE_BOOST_POWER);
+}
+
+static LtcError_t ltcOptimizeCacheRange(const LtcAllocator *allocator, const LtcIndexBuffer *indices, uint32_t firstIndex,
+                                        uint32_t numIndices, uint32_t baseVertex, uint32_t numVertices)
+{
+    uint32_t numTriangles = numIndices / 3;
+    if(numTriangles < 2)
+        return LTC_OK;
+
+    size_t bytes = (size_t)numIndices * 2 * sizeof(uint32_t) +
+                   (size_t)numTriangles * (sizeof(float) + 1) +
+                   (size_t)numVertices * (2 * sizeof(uint32_t) + sizeof(int32_t) + sizeof(float)) + sizeof(uint32_t);
+    uint8_t *scratch = (uint8_t *)allocator->m_alloc(bytes, allocator->m_userData);
+    if(!scratch)
+        return LTC_ERR_OUTOFMEMORY;
+
+    /* 4 byte arrays first so everything stays aligned */
+    uint32_t *triangles     = (uint32_t *)scratch;
+    uint32_t *adjacency     = triangles + numIndices;
+    uint32_t *adjOffset     = adjacency + numIndices;
+    uint32_t *liveTriangles = adjOffset + numVertices + 1;
+    int32_t  *cachePos      = (int32_t *)(liveTriangles + numVertices);
+    float    *vertexScore   = (float *)(cachePos + numVertices);
+    float    *triangleScore = vertexScore + numVertices;
+    uint8_t  *emitted       = (uint8_t *)(triangleScore + numTriangles);
+
+    LtcScoreTables tables;
+    ltcInitScoreTables(&tables);
+
+    memset(liveTriangles, 0, numVertices * sizeof(uint32_t));
+    for(uint32_t i = 0; i < numTriangles * 3; ++i)
+    {
+        triangles[i] = ltcReadIndex(indices, firstIndex + i) - baseVertex;
+        ++liveTriangles[triangles[i]];
+    }
+
+    adjOffset[0] = 0;
+    for(uint32_t v = 0; v < numVertices; ++v)
+        adjOffset[v + 1] = adjOffset[v] + liveTriangles[v];
+    memset(liveTriangles, 0, numVertices * sizeof(uint32_t));
+    for(uint32_t t = 0; t < numTriangles; ++t)
+    {
+        for(uint32_t k = 0; k < 3; ++k)
+        {
+            uint32_t v = triangles[3 * t + k];
+            adjacency[adjOffset[v] + liveTriangles[v]++] = t;
+        }
+    }
+
+    for(uint32_t v = 0; v < numVertices; ++v)
+    {
+        cachePos[v]    = -1;
+        vertexScore[v] = ltcVertexScore(&tables, -1, liveTriangles[v]);
+    }
+    for(uint32_t t = 0; t < numTriangles; ++t)
+    {
+        const uint32_t *tri = &triangles[3 * t];
+        triangleScore[t] = vertexScore[tri[0]] + vertexScore[tri[1]] + vertexScore[tri[2]];
+        emitted[t] = 0;
+    }
+
+    uint32_t cache[LTC_VERTEX_CACHE_SIZE + 3];
+    uint32_t cacheSize = 0;
+    uint32_t cursor = 0;
+    uint32_t out = firstIndex;
+    int64_t best = 0;
+
+    for(uint32_t n = 0; n < numTriangles; ++n)
+    {
+        /* dead end: carry on with the next triangle in input order */
+        if(best < 0)
+        {
+            while(emitted[cursor])
+                ++cursor;
+            best = cursor;
+        }
+
+        uint32_t t = (uint32_t)best;
+        const uint32_t *tri = &triangles[3 * t];
+        emitted[t] = 1;
+        for(uint32_t k = 0; k < 3; ++k)
+            ltcWriteIndex(indices, out++, tri[k] + baseVertex);
+
+        /* push the triangle to the front of the cache and retire it from
+         * its vertices' lists */
+        uint32_t newCache[LTC_VERTEX_CACHE_SIZE + 6];
+        uint32_t newSize = 0;
+        for(uint32_t k = 0; k < 3; ++k)
+        {
+            uint32_t v = tri[k];
+            newCache[newSize++] = v;
+
+            uint32_t *list = &adjacency[adjOffset[v]];
+            uint32_t live = liveTriangles[v]--;
+            for(uint32_t a = 0; a < live; ++a)
+            {
+                if(list[a] == t)
+                {
+                    list[a] = list[live - 1];
+                    break;
+                }
+            }
+        }
+        for(uint32_t c = 0; c < cacheSize; ++c)
+        {
+            uint32_t v = cache[c];
+            if(v != tri[0] && v != tri[1] && v != tri[2])
+                newCache[newSize++] = v;
+        }
+        for(uint32_t c = LTC_VERTEX_CACHE_SIZE + 3; c < newSize; ++c)
+            cachePos[newCache[c]] = -1;
+        cacheSize = newSize < LTC_VERTEX_CACHE_SIZE + 3 ? newSize : LTC_VERTEX_CACHE_SIZE + 3;
+
+        /* rescore what moved and pick the best triangle touching the cache */
+        float bestScore = -1.0f;
+        best = -1;
+        for(uint32_t c = 0; c < cacheSize; ++c)
+        {
+            uint32_t v = newCache[c];
+            cache[c] = v;
+            cachePos[v] = c < LTC_VERTEX_CACHE_SIZE ? (int32_t)c : -1;
+
+            float score = ltcVertexScore(&tables, cachePos[v], liveTriangles[v]);
+            float delta = score - vertexScore[v];
+            vertexScore[v] = score;
+
+            const uint32_t *list = &adjacency[adjOffset[v]];
+            for(uint32_t a = 0; a < liveTriangles[v]; ++a)
+                triangleScore[list[a]] += delta;
+        }
+        for(uint32_t c = 0; c < cacheSize && c < LTC_VERTEX_CACHE_SIZE; ++c)
+        {
+            uint32_t v = cache[c];
+            const uint32_t *list = &adjacency[adjOffset[v]];
+            for(uint32_t a = 0; a < liveTriangles[v]; ++a)
+            {
+                uint32_t candidate = list[a];
+                if(triangleScore[candidate] > bestScore ||
+                   (triangleScore[candidate] == bestScore && candidate < (uint32_t)best))
+                {
+                    bestScore = triangleScore[candidate];
+                    best = candidate;
+                }
+            }
+        }
+    }
+
+    allocator->m_free(scratch, allocator->m_userData);
+    return LTC_OK;
+}
+
+/* Renumbers vertices in order of first use so fetches walk the vertex
+ * buffers front to back; vertices no index refers to keep their relative
+ * order at the end. */
+static LtcError_t ltcOptimizeFetchRange(const LtcAllocator *allocator, const LtcVertexWriter *writer,
+                                        const LtcIndexBuffer *indices, uint32_t firstIndex, uint32_t numIndices,
+                                        uint32_t indexBase, uint32_t firstVertex, uint32_t numVertices)
+{
+    if(numVertices == 0)
+        return LTC_OK;
+
+    uint32_t *remap = (uint32_t *)allocator->m_alloc((size_t)numVertices * 2 * sizeof(uint32_t), allocator->m_userData);
+    if(!remap)
+        return LTC_ERR_OUTOFMEMORY;
+    uint8_t *copy = (uint8_t *)(remap + numVertices);
+
+    memset(remap, 0xFF, (size_t)numVertices * sizeof(uint32_t));
+    uint32_t next = 0;
+    for(uint32_t i = firstIndex; i < firstIndex + numIndices; ++i)
+    {
+        uint32_t v = ltcReadIndex(indices, i) - indexBase;
+        if(remap[v] == UINT32_MAX)
+            remap[v] = next++;
+        ltcWriteIndex(indices, i, remap[v] + indexBase);
+    }
+    for(uint32_t v = 0; v < numVertices; ++v)
+    {
+        if(remap[v] == UINT32_MAX)
+            remap[v] = next++;
+    }
+
+    for(uint32_t o = 0; o < writer->m_numOutputs; ++o)
+    {
+        const LtcAttribOutput *output = &writer->m_outputs[o];
+        for(uint32_t c = 0; c < output->m_numStored; ++c)
+        {
+            uint8_t *stream = output->m_buffer + (size_t)firstVertex * output->m_stride + c * output->m_componentStride;
+            for(uint32_t v = 0; v < numVertices; ++v)
+                memcpy(copy + (size_t)v * output->m_componentSize, stream + (size_t)v * output->m_stride, output->m_componentSize);
+            for(uint32_t v = 0; v < numVertices; ++v)
+                memcpy(stream + (size_t)remap[v] * output->m_stride, copy + (size_t)v * output->m_componentSize, output->m_componentSize);
+        }
+    }
+
+    allocator->m_free(remap, allocator->m_userData);
+    return LTC_OK;
+}
+
+LtcError_t ltcOptimizeRange(const LtcAllocator *allocator, uint32_t flags, const LtcVertexWriter *writer,
+                            const LtcIndexBuffer *indices, uint32_t firstIndex, uint32_t numIndices,
+                            uint32_t indexBase, uint32_t firstVertex, uint32_t numVertices)
+{
+    LtcError_t err = LTC_OK;
+    if(flags & LTC_CONFIG_FLAG_OPTIMIZE_VERTEX_CACHE)
+        err = ltcOptimizeCacheRange(allocator, indices, firstIndex, numIndices, indexBase, numVertices);
+    if(err == LTC_OK && (flags & LTC_CONFIG_FLAG_OPTIMIZE_VERTEX_FETCH))
+        err = ltcOptimizeFetchRange(allocator, writer, indices, firstIndex, numIndices, indexBase, firstVertex, numVertices);
+    return err;
+}
+
+static LtcError_t ltcValidateIndices(const LtcIndexBuffer *indices, uint32_t numIndices, uint32_t numVertices)
+{
+    if(!indices || (numIndices && !indices->m_buffer) ||
+       (indices->m_indexSize != LTC_INDEX_SIZE_8 && indices->m_indexSize != LTC_INDEX_SIZE_16 &&
+        indices->m_indexSize != LTC_INDEX_SIZE_32))
+        return LTC_ERR_INVALIDARGS;
+
+    for(uint32_t i = 0; i < numIndices; ++i)
+    {
+        if(ltcReadIndex(indices, i) >= numVertices)
+            return LTC_ERR_INVALIDARGS;
+    }
+    return LTC_OK;
+}
+
+LtcError_t ltcOptimizeVertexCache(const LtcIndexBuffer *indices, uint32_t numIndices, uint32_t numVertices,
+                                  const LtcAllocator *allocator)
+{
+    LtcAllocator defaultAllocator;
+    if(!allocator)
+    {
+        ltcInitDefaultAllocator(&defaultAllocator);
+        allocator = &defaultAllocator;
+    }
+    if(ltcValidateAllocator(allocator) != LTC_OK || numIndices % 3 ||
+       ltcValidateIndices(indices, numIndices, numVertices) != LTC_OK)
+        return LTC_ERR_INVALIDARGS;
+
+    return ltcOptimizeCacheRange(allocator, indices, 0, numIndices, 0, numVertices);
+}
+
+LtcError_t ltcOptimizeVertexFetch(LtcGeometry *geometry)
+{
+    if(!geometry || !geometry->m_indices)
+        return LTC_ERR_INVALIDARGS;
+
+    LtcAllocator allocator = geometry->m_allocator;
+    if(ltcValidateAllocator(&allocator) != LTC_OK)
+        ltcInitDefaultAllocator(&allocator);
+
+    LtcIndexBuffer indices = *geometry->m_indices;
+    if(geometry->m_indexSize != LTC_INDEX_SIZE_NONE)
+        indices.m_indexSize = geometry->m_indexSize;
+    if(ltcValidateBuffers(geometry, geometry->m_numVertices) != LTC_OK ||
+       ltcValidateIndices(&indices, geometry->m_numIndices, geometry->m_numVertices) != LTC_OK)
+        return LTC_ERR_INVALIDARGS;
+
+    /* the vertex order no longer matches a fresh generation */
+    memset(geometry->m_topology, 0, sizeof(geometry->m_topology));
+
+    LtcVertexWriter writer;
+    ltcInitVertexWriter(geometry, &writer);
+    LtcError_t err = ltcOptimizeFetchRange(&allocator, &writer, &indices, 0, geometry->m_numIndices, 0, 0,
+                                           geometry->m_numVertices);
+    if(err == LTC_OK)
+        ltcPadVertexStreams(&writer, geometry->m_numVertices);
+    return err;
+}
+
+LtcError_t ltcAnalyzeVertexCache(const LtcIndexBuffer *indices, uint32_t numIndices, uint32_t numVertices,
+                                 uint32_t cacheSize, const LtcAllocator *allocator, LtcVertexCacheStats *outStats)
+{
+    LtcAllocator defaultAllocator;
+    if(!allocator)
+    {
+        ltcInitDefaultAllocator(&defaultAllocator);
+        allocator = &defaultAllocator;
+    }
+    if(!outStats || cacheSize == 0 || ltcValidateAllocator(allocator) != LTC_OK || numIndices % 3 ||
+       ltcValidateIndices(indices, numIndices, numVertices) != LTC_OK)
+        return LTC_ERR_INVALIDARGS;
+
+    /* a vertex is cached while fewer than cacheSize misses happened since it
+     * was last loaded */
+    uint32_t *loadedAt = (uint32_t *)allocator->m_alloc((size_t)numVertices * sizeof(uint32_t) + 1, allocator->m_userData);
+    if(!loadedAt)
+        return LTC_ERR_OUTOFMEMORY;
+    memset(loadedAt, 0, (size_t)numVertices * sizeof(uint32_t));
+
+    uint32_t misses = 0;
+    uint32_t referenced = 0;
+    for(uint32_t i = 0; i < numIndices; ++i)
+    {
+        uint32_t v = ltcReadIndex(indices, i);
+        if(loadedAt[v] == 0)
+            ++referenced;
+        if(loadedAt[v] == 0 || misses - loadedAt[v] >= cacheSize)
+            loadedAt[v] = ++misses;
+    }
+    allocator->m_free(loadedAt, allocator->m_userData);
+
+    outStats->m_numTransformed = misses;
+    outStats->m_acmr = numIndices ? (float)misses / (float)(numIndices / 3) : 0.0f;
+    outStats->m_atvr = referenced ? (float)misses / (float)referenced : 0.0f;
+    return LTC_OK;
+}
@@ -0,0 +1,292 @@
+#include <lattica/stream.h>
+#include "internal.h"
+
+/* Pieces queued before a batch is emitted; large chunks go out in several
+ * batches. */
+#define LTC_STREAM_PIECES 128
+
+/* Where the stream stands: the next vertex row of one patch copy, and the
+ * stream positions the next chunk starts at. */
+typedef struct
+{
+    const LtcLayout *m_layout;
+    uint32_t         m_maxVertices;
+    int              m_global;
+    uint32_t         m_patch;
+    uint32_t         m_copy;
+    uint32_t         m_row;
+    uint64_t         m_chunk;
+    uint64_t         m_vertex;
+    uint64_t         m_index;
+} LtcStreamCursor;
+
+typedef struct
+{
+    LtcEmitPiece            m_pieces[LTC_STREAM_PIECES];
+    uint32_t                m_numPieces;
+    uint32_t                m_numVertices;
+    const LtcAllocator     *m_allocator;
+    const LtcTaskInterface *m_taskInterface;
+    const LtcVertexWriter  *m_writer;
+    const LtcIndexBuffer   *m_indices;
+    LtcError_t              m_err;
+} LtcStreamEmitter;
+
+static void ltcFlushPieces(LtcStreamEmitter *emitter)
+{
+    if(emitter->m_numPieces && emitter->m_err == LTC_OK)
+        emitter->m_err = ltcEmitPieces(emitter->m_pieces, emitter->m_numPieces, emitter->m_numVertices, emitter->m_allocator,
+                                       emitter->m_taskInterface, emitter->m_writer, emitter->m_indices);
+    emitter->m_numPieces   = 0;
+    emitter->m_numVertices = 0;
+}
+
+/* Queues piece cut into row ranges of about LTC_TASK_VERTICES, so one chunk
+ * still spreads over the tasks. */
+static void ltcPushPiece(LtcStreamEmitter *emitter, const LtcEmitPiece *piece)
+{
+    const LtcPatch *patch = piece->m_patch;
+    uint32_t rowSize = patch->m_divU + 1;
+    uint32_t rowsPerPiece = LTC_TASK_VERTICES / rowSize ? LTC_TASK_VERTICES / rowSize : 1;
+    for(uint32_t row = piece->m_rowBegin; row < piece->m_rowEnd; row += rowsPerPiece)
+    {
+        if(emitter->m_numPieces == LTC_STREAM_PIECES)
+            ltcFlushPieces(emitter);
+
+        LtcEmitPiece *part = &emitter->m_pieces[emitter->m_numPieces++];
+        *part = *piece;
+        part->m_rowBegin    = row;
+        part->m_rowEnd      = piece->m_rowEnd - row > rowsPerPiece ? row + rowsPerPiece : piece->m_rowEnd;
+        part->m_quadEnd     = part->m_rowEnd < piece->m_quadEnd ? part->m_rowEnd : piece->m_quadEnd;
+        part->m_firstVertex = piece->m_firstVertex + (row - piece->m_rowBegin) * rowSize;
+        part->m_firstIndex  = piece->m_firstIndex + ltcQuadRowsIndexCount(patch, piece->m_rowBegin, row);
+        emitter->m_numVertices += (part->m_rowEnd - row) * rowSize;
+    }
+}
+
+/* Fills the chunk starting at cursor with as many vertex rows as fit, in
+ * output order, and moves cursor past it. A local chunk ends on a whole quad
+ * row and the next one repeats its last vertex row; a global chunk ends
+ * between vertex rows. Pieces go to emitter when not NULL. */
+static LtcError_t ltcNextChunk(LtcStreamCursor *cursor, LtcStreamChunk *outChunk, LtcStreamEmitter *emitter)
+{
+    const LtcLayout *layout = cursor->m_layout;
+    uint32_t numVertices = 0;
+    uint64_t numIndices  = 0;
+
+    while(cursor->m_patch < layout->m_numPatches)
+    {
+        const LtcPatch *patch = &layout->m_patches[cursor->m_patch];
+        uint32_t rowSize  = patch->m_divU + 1;
+        uint32_t rowsLeft = (cursor->m_maxVertices - numVertices) / rowSize;
+
+        LtcEmitPiece piece;
+        piece.m_patch       = patch;
+        piece.m_copy        = cursor->m_copy;
+        piece.m_rowBegin    = cursor->m_row;
+        piece.m_firstVertex = numVertices;
+        piece.m_firstIndex  = (uint32_t)numIndices;
+        if(cursor->m_global)
+        {
+            if(rowsLeft < 1)
+                break;
+            uint32_t rows = patch->m_divV + 1 - cursor->m_row;
+            piece.m_rowEnd  = cursor->m_row + (rows < rowsLeft ? rows : rowsLeft);
+            piece.m_quadEnd = piece.m_rowEnd < patch->m_divV ? piece.m_rowEnd : patch->m_divV;
+            /* index values count from the start of the stream, which fits
+             * 32 bits when generating */
+            piece.m_indexBase = 0u - (uint32_t)cursor->m_vertex;
+        }
+        else
+        {
+            if(rowsLeft < 2)
+                break;
+            uint32_t quads = patch->m_divV - cursor->m_row;
+            piece.m_quadEnd   = cursor->m_row + (quads < rowsLeft - 1 ? quads : rowsLeft - 1);
+            piece.m_rowEnd    = piece.m_quadEnd + 1;
+            piece.m_indexBase = 0;
+        }
+
+        if(emitter)
+            ltcPushPiece(emitter, &piece);
+        numVertices += (piece.m_rowEnd - piece.m_rowBegin) * rowSize;
+        numIndices  += ltcQuadRowsIndexCount(patch, piece.m_rowBegin, piece.m_quadEnd);
+        if(numIndices > UINT32_MAX)
+            return LTC_ERR_INVALIDARGS;
+
+        cursor->m_row = cursor->m_global ? piece.m_rowEnd : piece.m_quadEnd;
+        if(cursor->m_row == patch->m_divV + (cursor->m_global ? 1 : 0))
+        {
+            cursor->m_row = 0;
+            if(++cursor->m_copy == patch->m_count)
+            {
+                cursor->m_copy = 0;
+                ++cursor->m_patch;
+            }
+        }
+    }
+
+    outChunk->m_chunk       = cursor->m_chunk++;
+    outChunk->m_firstVertex = cursor->m_vertex;
+    outChunk->m_firstIndex  = cursor->m_index;
+    outChunk->m_numVertices = numVertices;
+    outChunk->m_numIndices  = (uint32_t)numIndices;
+    cursor->m_vertex += numVertices;
+    cursor->m_index  += numIndices;
+    return LTC_OK;
+}
+
+static LtcError_t ltcInitStreamCursor(const LtcConfig *config, const LtcLayout *layout, uint32_t maxChunkVertices,
+                                      uint32_t flags, LtcStreamCursor *cursor)
+{
+    int global = (flags & LTC_STREAM_FLAG_GLOBAL_INDICES) != 0;
+    if((flags & ~(uint32_t)LTC_STREAM_FLAG_GLOBAL_INDICES) || (global && config->m_flags))
+        return LTC_ERR_INVALIDARGS;
+
+    /* every chunk has to make progress */
+    for(uint32_t p = 0; p < layout->m_numPatches; ++p)
+    {
+        if((uint64_t)(layout->m_patches[p].m_divU + 1) * (global ? 1 : 2) > maxChunkVertices)
+            return LTC_ERR_INVALIDARGS;
+    }
+
+    cursor->m_layout      = layout;
+    cursor->m_maxVertices = maxChunkVertices;
+    cursor->m_global      = global;
+    cursor->m_patch       = 0;
+    cursor->m_copy        = 0;
+    cursor->m_row         = 0;
+    cursor->m_chunk       = 0;
+    cursor->m_vertex      = 0;
+    cursor->m_index       = 0;
+    return LTC_OK;
+}
+
+static LtcError_t ltcPlanStream(const LtcConfig *config, const LtcLayout *layout, uint32_t maxChunkVertices, uint32_t flags,
+                                LtcStreamSize *outSize)
+{
+    LtcStreamCursor cursor;
+    LtcError_t err = ltcInitStreamCursor(config, layout, maxChunkVertices, flags, &cursor);
+    if(err != LTC_OK)
+        return err;
+
+    outSize->m_maxChunkSize.m_numVertices = 0;
+    outSize->m_maxChunkSize.m_numIndices  = 0;
+    while(cursor.m_patch < layout->m_numPatches)
+    {
+        LtcStreamChunk chunk;
+        err = ltcNextChunk(&cursor, &chunk, NULL);
+        if(err != LTC_OK)
+            return err;
+        if(chunk.m_numVertices > outSize->m_maxChunkSize.m_numVertices)
+            outSize->m_maxChunkSize.m_numVertices = chunk.m_numVertices;
+        if(chunk.m_numIndices > outSize->m_maxChunkSize.m_numIndices)
+            outSize->m_maxChunkSize.m_numIndices = chunk.m_numIndices;
+    }
+
+    outSize->m_numChunks   = cursor.m_chunk;
+    outSize->m_numVertices = cursor.m_vertex;
+    outSize->m_numIndices  = cursor.m_index;
+    return LTC_OK;
+}
+
+LtcError_t ltcQueryGeometryStream(const LtcConfig *config, uint32_t maxChunkVertices, uint32_t flags,
+                                  LtcStreamSize *outSize)
+{
+    if(!config || !outSize)
+        return LTC_ERR_INVALIDARGS;
+
+    LtcLayout layout;
+    LtcError_t err = ltcBuildLayout(config, &layout);
+    if(err != LTC_OK)
+        return err;
+
+    return ltcPlanStream(config, &layout, maxChunkVertices, flags, outSize);
+}
+
+LtcError_t ltcGenerateGeometryStream(const LtcConfig *config, uint32_t maxChunkVertices, uint32_t flags,
+                                     LtcGeometry *chunkGeometry, LtcStreamFn fn, void *userData)
+{
+    if(!config || !chunkGeometry || !fn)
+        return LTC_ERR_INVALIDARGS;
+
+    LtcLayout layout;
+    LtcError_t err = ltcBuildLayout(config, &layout);
+    if(err != LTC_OK)
+        return err;
+
+    LtcStreamSize size;
+    err = ltcPlanStream(config, &layout, maxChunkVertices, flags, &size);
+    if(err != LTC_OK)
+        return err;
+
+    const LtcAllocator *allocator = ltcGetAllocator(config);
+    if(ltcValidateAllocator(allocator) != LTC_OK)
+        return LTC_ERR_INVALIDARGS;
+
+    /* buffers hold one chunk; global index values span the whole stream */
+    uint32_t chunkRange = ltcIndexRange(config->m_indexTopology, size.m_maxChunkSize.m_numVertices);
+    err = ltcValidateBuffers(chunkGeometry, chunkRange);
+    if(err != LTC_OK)
+        return err;
+
+    if(flags & LTC_STREAM_FLAG_GLOBAL_INDICES)
+    {
+        uint64_t streamRange = size.m_numVertices + (config->m_indexTopology == LTC_INDEX_TOPOLOGY_TRIANGLE_STRIP ? 1 : 0);
+        if(chunkGeometry->m_indices && streamRange > (uint64_t)UINT32_MAX + 1)
+            return LTC_ERR_INVALIDARGS;
+
+        uint32_t range = streamRange > UINT32_MAX ? UINT32_MAX : (uint32_t)streamRange;
+        ltcResolveIndexSize(chunkGeometry, range);
+        if(chunkGeometry->m_indices && ltcGetIndexSizeForVertices(range) > chunkGeometry->m_indexSize)
+            return LTC_ERR_INVALIDARGS;
+    }
+    else
+    {
+        ltcResolveIndexSize(chunkGeometry, chunkRange);
+    }
+
+    err = ltcAllocateBuffers(allocator, chunkGeometry, &size.m_maxChunkSize);
+    if(err != LTC_OK)
+        return err;
+
+    LtcVertexWriter writer;
+    ltcInitVertexWriter(chunkGeometry, &writer);
+
+    LtcIndexBuffer indices;
+    LtcStreamEmitter emitter;
+    emitter.m_numPieces     = 0;
+    emitter.m_numVertices   = 0;
+    emitter.m_allocator     = allocator;
+    emitter.m_taskInterface = config->m_taskInterface;
+    emitter.m_writer        = &writer;
+    emitter.m_indices       = ltcGetWrittenIndices(chunkGeometry, &indices);
+    emitter.m_err           = LTC_OK;
+
+    LtcStreamCursor cursor;
+    err = ltcInitStreamCursor(config, &layout, maxChunkVertices, flags, &cursor);
+    if(err != LTC_OK)
+        return err;
+    while(cursor.m_patch < layout.m_numPatches)
+    {
+        LtcStreamChunk chunk;
+        err = ltcNextChunk(&cursor, &chunk, &emitter);
+        ltcFlushPieces(&emitter);
+        if(err == LTC_OK)
+            err = emitter.m_err;
+        if(err == LTC_OK && emitter.m_indices)
+            err = ltcOptimizeRange(allocator, config->m_flags, &writer, &indices, 0, chunk.m_numIndices, 0, 0,
+                                   chunk.m_numVertices);
+        if(err != LTC_OK)
+            return err;
+
+        ltcPadVertexStreams(&writer, chunk.m_numVertices);
+        chunkGeometry->m_numVertices = chunk.m_numVertices;
+        chunkGeometry->m_numIndices  = emitter.m_indices ? chunk.m_numIndices : 0;
+        err = fn(&chunk, chunkGeometry, userData);
+        if(err != LTC_OK)
+            return err;
+    }
+
+    return LTC_OK;
+}
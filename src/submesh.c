@@ -0,0 +1,191 @@
+#include "internal.h"
+
+/* Strips lose the largest index value to the restart index. */
+static uint64_t ltcMaxSubmeshVertices(LtcIndexSize_t indexSize, LtcIndexTopology_t topology)
+{
+    uint64_t restart = topology == LTC_INDEX_TOPOLOGY_TRIANGLE_STRIP ? 1 : 0;
+    switch(indexSize)
+    {
+    case LTC_INDEX_SIZE_8:
+        return 0xFFu + 1 - restart;
+    case LTC_INDEX_SIZE_16:
+        return 0xFFFFu + 1 - restart;
+    default:
+        return UINT32_MAX;
+    }
+}
+
+static LtcIndexSize_t ltcSubmeshIndexSize(LtcIndexSize_t indexSize, LtcIndexTopology_t topology, uint32_t numVertices)
+{
+    if(indexSize != LTC_INDEX_SIZE_AUTO)
+        return indexSize;
+    indexSize = ltcGetIndexSizeForVertices(ltcIndexRange(topology, numVertices));
+    return indexSize == LTC_INDEX_SIZE_32 ? LTC_INDEX_SIZE_16 : indexSize;
+}
+
+/* Packs patch copies into submeshes of at most maxVertices vertices in output
+ * order. A copy that does not fit in what is left of the open submesh is cut
+ * after as many quad rows as fit and continued, starting with a copy of the
+ * cut row, in the next one. Fills submeshes and pieces when not NULL. */
+static LtcError_t ltcPlanSubmeshes(const LtcLayout *layout, uint64_t maxVertices, LtcSubmesh *submeshes,
+                                   LtcEmitPiece *pieces, uint32_t *outNumSubmeshes, uint32_t *outNumPieces,
+                                   LtcGeometrySize *outSize)
+{
+    uint32_t numSubmeshes = 0;
+    uint32_t numPieces = 0;
+    uint64_t vertex = 0;
+    uint64_t index  = 0;
+    LtcSubmesh current = { 0, 0, 0, 0 };
+
+    for(uint32_t p = 0; p < layout->m_numPatches; ++p)
+    {
+        const LtcPatch *patch = &layout->m_patches[p];
+        uint32_t rowSize = patch->m_divU + 1;
+        if(2 * (uint64_t)rowSize > maxVertices)
+            return LTC_ERR_INVALIDARGS;
+
+        for(uint32_t copy = 0; copy < patch->m_count; ++copy)
+        {
+            uint32_t row = 0;
+            while(row < patch->m_divV)
+            {
+                uint64_t rowsLeft = numSubmeshes ? (maxVertices - current.m_numVertices) / rowSize : 0;
+                if(rowsLeft < 2)
+                {
+                    if(numSubmeshes && submeshes)
+                        submeshes[numSubmeshes - 1] = current;
+                    current.m_baseVertex  = (uint32_t)vertex;
+                    current.m_numVertices = 0;
+                    current.m_firstIndex  = (uint32_t)index;
+                    current.m_numIndices  = 0;
+                    ++numSubmeshes;
+                    continue;
+                }
+
+                uint32_t quads = patch->m_divV - row;
+                if(quads > rowsLeft - 1)
+                    quads = (uint32_t)(rowsLeft - 1);
+                uint32_t numVertices = (quads + 1) * rowSize;
+                uint32_t numIndices  = ltcQuadRowsIndexCount(patch, row, row + quads);
+
+                if(pieces)
+                {
+                    LtcEmitPiece *piece = &pieces[numPieces];
+                    piece->m_patch       = patch;
+                    piece->m_copy        = copy;
+                    piece->m_rowBegin    = row;
+                    piece->m_rowEnd      = row + quads + 1;
+                    piece->m_quadEnd     = row + quads;
+                    piece->m_firstVertex = (uint32_t)vertex;
+                    piece->m_firstIndex  = (uint32_t)index;
+                    piece->m_indexBase   = current.m_baseVertex;
+                }
+                ++numPieces;
+
+                vertex += numVertices;
+                index  += numIndices;
+                if(vertex > UINT32_MAX || index > UINT32_MAX)
+                    return LTC_ERR_INVALIDARGS;
+                current.m_numVertices += numVertices;
+                current.m_numIndices  += numIndices;
+                row += quads;
+            }
+        }
+    }
+    if(numSubmeshes && submeshes)
+        submeshes[numSubmeshes - 1] = current;
+
+    *outNumSubmeshes = numSubmeshes;
+    *outNumPieces = numPieces;
+    outSize->m_numVertices = (uint32_t)vertex;
+    outSize->m_numIndices  = (uint32_t)index;
+    return LTC_OK;
+}
+
+LtcError_t ltcQueryGeometrySubmeshes(const LtcConfig *config, LtcIndexSize_t indexSize,
+                                     uint32_t *outNumSubmeshes, LtcGeometrySize *outSize)
+{
+    if(!config || !outNumSubmeshes || !outSize)
+        return LTC_ERR_INVALIDARGS;
+
+    LtcLayout layout;
+    LtcError_t err = ltcBuildLayout(config, &layout);
+    if(err != LTC_OK)
+        return err;
+
+    LtcGeometrySize size;
+    err = ltcLayoutSize(&layout, &size);
+    if(err != LTC_OK)
+        return err;
+
+    uint32_t numPieces;
+    indexSize = ltcSubmeshIndexSize(indexSize, config->m_indexTopology, size.m_numVertices);
+    return ltcPlanSubmeshes(&layout, ltcMaxSubmeshVertices(indexSize, config->m_indexTopology), NULL, NULL,
+                            outNumSubmeshes, &numPieces, outSize);
+}
+
+LtcError_t ltcGenerateGeometrySubmeshes(const LtcConfig *config, LtcSubmesh *outSubmeshes, LtcGeometry *outGeometry)
+{
+    if(!config || !outSubmeshes || !outGeometry || !outGeometry->m_indices)
+        return LTC_ERR_INVALIDARGS;
+
+    LtcLayout layout;
+    LtcError_t err = ltcBuildLayout(config, &layout);
+    if(err != LTC_OK)
+        return err;
+
+    LtcGeometrySize size;
+    err = ltcLayoutSize(&layout, &size);
+    if(err != LTC_OK)
+        return err;
+
+    const LtcAllocator *allocator = ltcGetAllocator(config);
+    if(ltcValidateAllocator(allocator) != LTC_OK)
+        return LTC_ERR_INVALIDARGS;
+
+    LtcIndexSize_t indexSize = ltcSubmeshIndexSize(outGeometry->m_indices->m_indexSize, config->m_indexTopology,
+                                                   size.m_numVertices);
+    uint64_t maxVertices = ltcMaxSubmeshVertices(indexSize, config->m_indexTopology);
+
+    uint32_t numSubmeshes, numPieces;
+    err = ltcPlanSubmeshes(&layout, maxVertices, NULL, NULL, &numSubmeshes, &numPieces, &size);
+    if(err != LTC_OK)
+        return err;
+
+    err = ltcValidateBuffers(outGeometry, ltcIndexRange(config->m_indexTopology,
+                             (uint32_t)(maxVertices < size.m_numVertices ? maxVertices : size.m_numVertices)));
+    if(err != LTC_OK)
+        return err;
+
+    LtcEmitPiece *pieces = (LtcEmitPiece *)allocator->m_alloc((size_t)numPieces * sizeof(LtcEmitPiece), allocator->m_userData);
+    if(!pieces)
+        return LTC_ERR_OUTOFMEMORY;
+    ltcPlanSubmeshes(&layout, maxVertices, outSubmeshes, pieces, &numSubmeshes, &numPieces, &size);
+
+    outGeometry->m_indexSize = indexSize;
+    err = ltcAllocateBuffers(allocator, outGeometry, &size);
+    if(err == LTC_OK)
+    {
+        LtcVertexWriter writer;
+        LtcIndexBuffer indices;
+        ltcInitVertexWriter(outGeometry, &writer);
+        err = ltcEmitPieces(pieces, numPieces, size.m_numVertices, allocator, config->m_taskInterface,
+                            &writer, ltcGetWrittenIndices(outGeometry, &indices));
+
+        for(uint32_t s = 0; s < numSubmeshes && err == LTC_OK; ++s)
+        {
+            const LtcSubmesh *submesh = &outSubmeshes[s];
+            err = ltcOptimizeRange(allocator, config->m_flags, &writer, &indices, submesh->m_firstIndex,
+                                   submesh->m_numIndices, 0, submesh->m_baseVertex, submesh->m_numVertices);
+        }
+        if(err == LTC_OK)
+        {
+            ltcPadVertexStreams(&writer, size.m_numVertices);
+            outGeometry->m_numVertices = size.m_numVertices;
+            outGeometry->m_numIndices  = size.m_numIndices;
+        }
+    }
+
+    allocator->m_free(pieces, allocator->m_userData);
+    return err;
+}
@@ -0,0 +1,265 @@
+#define _POSIX_C_SOURCE 200112L
+#include <lattica/threadpool.h>
+#include "internal.h"
+#include <pthread.h>
+#include <unistd.h>
+
+/* Tasks [m_begin, m_end) still queued on one worker. The owner pops from the
+ * front, thieves split off the back half. */
+typedef struct
+{
+    pthread_mutex_t m_lock;
+    uint32_t        m_begin;
+    uint32_t        m_end;
+} LtcTaskRange;
+
+typedef struct
+{
+    LtcThreadPool *m_pool;
+    pthread_t      m_thread;
+    LtcTaskRange   m_range;
+    uint32_t       m_index;
+} LtcWorker;
+
+struct LtcThreadPool
+{
+    LtcAllocator     m_allocator;
+    LtcTaskInterface m_taskInterface;
+    LtcWorker       *m_workers;
+    uint32_t         m_numWorkers;   /* worker 0 is whoever calls m_wait */
+    uint32_t         m_numStarted;
+
+    pthread_mutex_t  m_runLock;
+    pthread_mutex_t  m_lock;
+    pthread_cond_t   m_wake;
+    pthread_cond_t   m_idle;
+    uint32_t         m_generation;
+    uint32_t         m_busy;
+    int              m_shutdown;
+
+    LtcTaskFn        m_fn;
+    void            *m_taskData;
+};
+
+static int ltcPopTask(LtcWorker *worker, uint32_t *outTask)
+{
+    int found = 0;
+    pthread_mutex_lock(&worker->m_range.m_lock);
+    if(worker->m_range.m_begin < worker->m_range.m_end)
+    {
+        *outTask = worker->m_range.m_begin++;
+        found = 1;
+    }
+    pthread_mutex_unlock(&worker->m_range.m_lock);
+    return found;
+}
+
+static int ltcStealTask(LtcWorker *worker, uint32_t *outTask)
+{
+    LtcThreadPool *pool = worker->m_pool;
+    for(uint32_t k = 1; k < pool->m_numWorkers; ++k)
+    {
+        LtcWorker *victim = &pool->m_workers[(worker->m_index + k) % pool->m_numWorkers];
+
+        pthread_mutex_lock(&victim->m_range.m_lock);
+        uint32_t end = victim->m_range.m_end;
+        uint32_t remaining = end - victim->m_range.m_begin;
+        uint32_t begin = end - (remaining + 1) / 2;
+        if(remaining)
+            victim->m_range.m_end = begin;
+        pthread_mutex_unlock(&victim->m_range.m_lock);
+        if(!remaining)
+            continue;
+
+        pthread_mutex_lock(&worker->m_range.m_lock);
+        worker->m_range.m_begin = begin + 1;
+        worker->m_range.m_end   = end;
+        pthread_mutex_unlock(&worker->m_range.m_lock);
+        *outTask = begin;
+        return 1;
+    }
+    return 0;
+}
+
+/* Runs tasks until none are left queued anywhere. */
+static void ltcDrainTasks(LtcWorker *worker)
+{
+    LtcThreadPool *pool = worker->m_pool;
+    uint32_t task;
+    while(ltcPopTask(worker, &task) || ltcStealTask(worker, &task))
+        pool->m_fn(pool->m_taskData, task);
+}
+
+static void *ltcWorkerMain(void *arg)
+{
+    LtcWorker *worker = (LtcWorker *)arg;
+    LtcThreadPool *pool = worker->m_pool;
+
+    /* jobs are counted from pool creation, so a thread that starts late
+     * still picks up the first one */
+    uint32_t seen = 0;
+    pthread_mutex_lock(&pool->m_lock);
+    for(;;)
+    {
+        while(!pool->m_shutdown && pool->m_generation == seen)
+            pthread_cond_wait(&pool->m_wake, &pool->m_lock);
+        if(pool->m_shutdown)
+            break;
+        seen = pool->m_generation;
+        pthread_mutex_unlock(&pool->m_lock);
+
+        ltcDrainTasks(worker);
+
+        pthread_mutex_lock(&pool->m_lock);
+        if(--pool->m_busy == 0)
+            pthread_cond_signal(&pool->m_idle);
+    }
+    pthread_mutex_unlock(&pool->m_lock);
+    return NULL;
+}
+
+/* Starts the tasks on the worker threads; they are shared with the calling
+ * thread once it reaches ltcThreadPoolWait. The run lock stays held until
+ * then so tasks of different callers never mix. */
+static void *ltcThreadPoolEnqueue(LtcTaskFn fn, void *taskData, uint32_t numTasks, void *userData)
+{
+    LtcThreadPool *pool = (LtcThreadPool *)userData;
+    pthread_mutex_lock(&pool->m_runLock);
+
+    /* contiguous shares keep neighbouring rows on one worker until stolen */
+    for(uint32_t w = 0; w < pool->m_numWorkers; ++w)
+    {
+        LtcTaskRange *range = &pool->m_workers[w].m_range;
+        pthread_mutex_lock(&range->m_lock);
+        range->m_begin = (uint32_t)((uint64_t)numTasks * w / pool->m_numWorkers);
+        range->m_end   = (uint32_t)((uint64_t)numTasks * (w + 1) / pool->m_numWorkers);
+        pthread_mutex_unlock(&range->m_lock);
+    }
+
+    pthread_mutex_lock(&pool->m_lock);
+    pool->m_fn       = fn;
+    pool->m_taskData = taskData;
+    pool->m_busy     = pool->m_numWorkers - 1;
+    ++pool->m_generation;
+    pthread_cond_broadcast(&pool->m_wake);
+    pthread_mutex_unlock(&pool->m_lock);
+    return pool;
+}
+
+static void ltcThreadPoolWait(void *handle, void *userData)
+{
+    LtcThreadPool *pool = (LtcThreadPool *)userData;
+    (void)handle;
+
+    ltcDrainTasks(&pool->m_workers[0]);
+
+    pthread_mutex_lock(&pool->m_lock);
+    while(pool->m_busy)
+        pthread_cond_wait(&pool->m_idle, &pool->m_lock);
+    pthread_mutex_unlock(&pool->m_lock);
+
+    pthread_mutex_unlock(&pool->m_runLock);
+}
+
+LtcError_t ltcThreadPoolCreate(const LtcAllocator *allocator, uint32_t numThreads, LtcThreadPool **outPool)
+{
+    if(!outPool)
+        return LTC_ERR_INVALIDARGS;
+
+    LtcAllocator parent;
+    if(allocator)
+        parent = *allocator;
+    else
+        ltcInitDefaultAllocator(&parent);
+    if(ltcValidateAllocator(&parent) != LTC_OK)
+        return LTC_ERR_INVALIDARGS;
+
+    if(numThreads == 0)
+    {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        numThreads = online > 0 ? (uint32_t)online : 1;
+    }
+
+    LtcThreadPool *pool = (LtcThreadPool *)parent.m_alloc(sizeof(LtcThreadPool), parent.m_userData);
+    if(!pool)
+        return LTC_ERR_OUTOFMEMORY;
+    pool->m_workers = (LtcWorker *)parent.m_alloc(numThreads * sizeof(LtcWorker), parent.m_userData);
+    if(!pool->m_workers)
+    {
+        parent.m_free(pool, parent.m_userData);
+        return LTC_ERR_OUTOFMEMORY;
+    }
+
+    pool->m_allocator  = parent;
+    pool->m_numWorkers = numThreads;
+    pool->m_taskInterface.m_enqueue    = ltcThreadPoolEnqueue;
+    pool->m_taskInterface.m_wait       = ltcThreadPoolWait;
+    pool->m_taskInterface.m_numWorkers = numThreads;
+    pool->m_taskInterface.m_userData   = pool;
+    pool->m_numStarted = 0;
+    pool->m_generation = 0;
+    pool->m_busy       = 0;
+    pool->m_shutdown   = 0;
+    pthread_mutex_init(&pool->m_runLock, NULL);
+    pthread_mutex_init(&pool->m_lock, NULL);
+    pthread_cond_init(&pool->m_wake, NULL);
+    pthread_cond_init(&pool->m_idle, NULL);
+
+    for(uint32_t w = 0; w < numThreads; ++w)
+    {
+        LtcWorker *worker = &pool->m_workers[w];
+        worker->m_pool          = pool;
+        worker->m_index         = w;
+        worker->m_range.m_begin = 0;
+        worker->m_range.m_end   = 0;
+        pthread_mutex_init(&worker->m_range.m_lock, NULL);
+    }
+
+    for(uint32_t w = 1; w < numThreads; ++w)
+    {
+        if(pthread_create(&pool->m_workers[w].m_thread, NULL, ltcWorkerMain, &pool->m_workers[w]) != 0)
+        {
+            ltcThreadPoolDestroy(pool);
+            return LTC_ERR_INTERNAL;
+        }
+        ++pool->m_numStarted;
+    }
+
+    *outPool = pool;
+    return LTC_OK;
+}
+
+void ltcThreadPoolDestroy(LtcThreadPool *pool)
+{
+    if(!pool)
+        return;
+
+    pthread_mutex_lock(&pool->m_lock);
+    pool->m_shutdown = 1;
+    pthread_cond_broadcast(&pool->m_wake);
+    pthread_mutex_unlock(&pool->m_lock);
+
+    for(uint32_t w = 1; w <= pool->m_numStarted; ++w)
+        pthread_join(pool->m_workers[w].m_thread, NULL);
+
+    for(uint32_t w = 0; w < pool->m_numWorkers; ++w)
+        pthread_mutex_destroy(&pool->m_workers[w].m_range.m_lock);
+    pthread_cond_destroy(&pool->m_idle);
+    pthread_cond_destroy(&pool->m_wake);
+    pthread_mutex_destroy(&pool->m_lock);
+    pthread_mutex_destroy(&pool->m_runLock);
+
+    LtcAllocator allocator = pool->m_allocator;
+    allocator.m_free(pool->m_workers, allocator.m_userData);
+    allocator.m_free(pool, allocator.m_userData);
+}
+
+uint32_t ltcThreadPoolGetNumThreads(const LtcThreadPool *pool)
+{
+    return pool ? pool->m_numWorkers : 0;
+}
+
+const LtcTaskInterface *ltcThreadPoolGetTaskInterface(LtcThreadPool *pool)
+{
+    return pool ? &pool->m_taskInterface : NULL;
+}
@@ -0,0 +1,222 @@
+#define _POSIX_C_SOURCE 199309L
+#include <lattica/generate.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Times ltcGenerateGeometry on spheres against a naive loop evaluating sinf /
+ * cosf per vertex, single threaded, vertices only. Every attribute is written,
+ * once into an interleaved buffer and once into SoA streams. Build with
+ * optimisations, e.g. CMAKE_BUILD_TYPE=Release.
+ *
+ * The store floor is a plain loop writing the same bytes. Sizes whose output
+ * fits the caches are compute bound and must reach LTC_BENCH_TARGET; larger
+ * ones approach the floor, so their speedup is bounded by write bandwidth
+ * (the bound column, naive time over the floor) and is only reported.
+ * Returns non-zero when a gated size falls short or any size differs from the
+ * naive loop by more than LTC_BENCH_TOLERANCE. */
+
+#define LTC_BENCH_TARGET    4.0
+#define LTC_BENCH_TOLERANCE 1e-5f
+
+#define LTC_BENCH_PI 3.14159265358979323846f
+
+typedef struct
+{
+    uint16_t m_divLongitude, m_divLatitude;
+    int      m_gated;
+    int      m_runs;
+} LtcBenchSize;
+
+static double ltcBenchNow(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Milliseconds since start, or best if that was faster. */
+static double ltcBenchElapsed(double start, double best)
+{
+    double elapsed = (ltcBenchNow() - start) * 1e3;
+    return elapsed < best ? elapsed : best;
+}
+
+static void ltcBenchStore(float *buffer, size_t bytes, float value)
+{
+    for(size_t i = 0; i < bytes / sizeof(float); ++i)
+        buffer[i] = value;
+}
+
+static void ltcBenchInitLayout(LtcVertexLayout *layout)
+{
+    ltcInitVertexLayout(layout);
+    ltcAddVertexElement(layout, LTC_VERTEX_ATTRIB_TYPE_POSITION, LTC_VERTEX_ATTRIB_SIZE_FLOAT3);
+    ltcAddVertexElement(layout, LTC_VERTEX_ATTRIB_TYPE_NORMAL, LTC_VERTEX_ATTRIB_SIZE_FLOAT3);
+    ltcAddVertexElement(layout, LTC_VERTEX_ATTRIB_TYPE_TEXCOORD, LTC_VERTEX_ATTRIB_SIZE_FLOAT2);
+    ltcAddVertexElement(layout, LTC_VERTEX_ATTRIB_TYPE_TANGENT, LTC_VERTEX_ATTRIB_SIZE_FLOAT4);
+    ltcAddVertexElement(layout, LTC_VERTEX_ATTRIB_TYPE_BITANGENT, LTC_VERTEX_ATTRIB_SIZE_FLOAT3);
+}
+
+/* A component stride of 0 keeps the components adjacent. */
+static size_t ltcBenchComponentStride(const LtcVertexAttribBuffer *attrib)
+{
+    return attrib->m_componentStride ? attrib->m_componentStride : sizeof(float);
+}
+
+static void ltcBenchWrite(const LtcVertexAttribBuffer *attrib, uint32_t vertex, float x, float y, float z, float w)
+{
+    float *out = (float *)((uint8_t *)attrib->m_buffer + (size_t)vertex * attrib->m_stride);
+    size_t step = ltcBenchComponentStride(attrib) / sizeof(float);
+    out[0] = x;
+    out[step] = y;
+    if(attrib->m_attribSize >= LTC_VERTEX_ATTRIB_SIZE_FLOAT3)
+        out[2 * step] = z;
+    if(attrib->m_attribSize == LTC_VERTEX_ATTRIB_SIZE_FLOAT4)
+        out[3 * step] = w;
+}
+
+/* The sphere vertex by vertex, as a straightforward implementation would
+ * write it: each vertex evaluates both of its angles with sinf / cosf. */
+static void ltcBenchNaiveSphere(const LtcConfigSphere *config, const LtcGeometry *geometry, uint32_t numVertices)
+{
+    const LtcVertexAttribBuffer *attribs = geometry->m_vertexAttribs;
+    uint32_t rowSize = config->m_divLongitude + 1u;
+    for(uint32_t vertex = 0; vertex < numVertices; ++vertex)
+    {
+        float u = (float)(vertex % rowSize) / (float)config->m_divLongitude;
+        float v = (float)(vertex / rowSize) / (float)config->m_divLatitude;
+        float theta = 2.0f * LTC_BENCH_PI * u;
+        float phi = LTC_BENCH_PI - LTC_BENCH_PI * v;
+        float st = sinf(theta), ct = cosf(theta);
+        float sp = sinf(phi), cp = cosf(phi);
+        float n[3] = { st * sp, cp, ct * sp };
+        ltcBenchWrite(&attribs[0], vertex, n[0] * config->m_radius, n[1] * config->m_radius, n[2] * config->m_radius,
+                      0.0f);
+        ltcBenchWrite(&attribs[1], vertex, n[0], n[1], n[2], 0.0f);
+        ltcBenchWrite(&attribs[2], vertex, u, v, 0.0f, 0.0f);
+        ltcBenchWrite(&attribs[3], vertex, ct, 0.0f, -st, 1.0f);
+        /* normal x tangent */
+        ltcBenchWrite(&attribs[4], vertex, -n[1] * st, n[2] * ct + n[0] * st, -n[1] * ct, 0.0f);
+    }
+}
+
+static float ltcBenchRead(const LtcVertexAttribBuffer *attrib, uint32_t vertex, uint32_t component)
+{
+    const uint8_t *in = (const uint8_t *)attrib->m_buffer + (size_t)vertex * attrib->m_stride;
+    return *(const float *)(in + component * ltcBenchComponentStride(attrib));
+}
+
+static float ltcBenchMaxDifference(const LtcGeometry *a, const LtcGeometry *b, uint32_t numVertices)
+{
+    float diff = 0.0f;
+    for(uint32_t slot = 0; slot < LTC_VERTEX_ATTRIB_COUNT; ++slot)
+    {
+        const LtcVertexAttribBuffer *attribA = &a->m_vertexAttribs[slot];
+        const LtcVertexAttribBuffer *attribB = &b->m_vertexAttribs[slot];
+        for(uint32_t v = 0; v < numVertices; ++v)
+        {
+            for(uint32_t c = 0; c < (uint32_t)attribA->m_attribSize; ++c)
+                diff = fmaxf(diff, fabsf(ltcBenchRead(attribA, v, c) - ltcBenchRead(attribB, v, c)));
+        }
+    }
+    return diff;
+}
+
+/* Returns 0 when the size passes. */
+static int ltcBenchRun(const LtcBenchSize *size, int streamed)
+{
+    LtcConfigSphere config;
+    ltcInitDefaultConfigSphere(&config);
+    config.m_divLongitude = size->m_divLongitude;
+    config.m_divLatitude  = size->m_divLatitude;
+
+    LtcGeometrySize geometrySize;
+    if(ltcQueryGeometrySize(&config.m_common, &geometrySize) != LTC_OK)
+        return 1;
+    uint32_t numVertices = geometrySize.m_numVertices;
+
+    LtcVertexLayout layout;
+    ltcBenchInitLayout(&layout);
+    size_t bytes = streamed ? ltcGetVertexStreamsBufferSize(&layout, numVertices, 32)
+                            : ltcGetVertexLayoutBufferSize(&layout, numVertices);
+    bytes = (bytes + 31) & ~(size_t)31;
+
+    /* geometry 0 is generated by lattica, geometry 1 by the naive loop */
+    float *buffers[2] = { aligned_alloc(32, bytes), aligned_alloc(32, bytes) };
+    LtcGeometry geometries[2];
+    int failed = !buffers[0] || !buffers[1];
+    for(int g = 0; g < 2 && !failed; ++g)
+    {
+        memset(&geometries[g], 0, sizeof(geometries[g]));
+        memset(buffers[g], 0, bytes);
+        LtcError_t err = streamed ? ltcSetVertexStreams(&geometries[g], &layout, numVertices, 32, buffers[g])
+                                  : ltcSetVertexLayout(&geometries[g], &layout, buffers[g]);
+        failed = err != LTC_OK;
+    }
+    if(failed)
+    {
+        free(buffers[0]);
+        free(buffers[1]);
+        return 1;
+    }
+
+    /* the three timings alternate so that clock and load changes hit them
+     * alike; each keeps its best run, small sizes running more often as
+     * their times are noisier */
+    double ms[2] = { 1e30, 1e30 };
+    double floor = 1e30;
+    for(int run = 0; run < size->m_runs && !failed; ++run)
+    {
+        double start = ltcBenchNow();
+        failed = ltcGenerateGeometry(&config.m_common, &geometries[0]) != LTC_OK;
+        ms[0] = ltcBenchElapsed(start, ms[0]);
+
+        start = ltcBenchNow();
+        ltcBenchNaiveSphere(&config, &geometries[1], numVertices);
+        ms[1] = ltcBenchElapsed(start, ms[1]);
+
+        start = ltcBenchNow();
+        ltcBenchStore(buffers[1], bytes, (float)run);
+        floor = ltcBenchElapsed(start, floor);
+    }
+    /* the floor overwrote the naive output */
+    memset(buffers[1], 0, bytes);
+    ltcBenchNaiveSphere(&config, &geometries[1], numVertices);
+
+    float diff = failed ? INFINITY : ltcBenchMaxDifference(&geometries[0], &geometries[1], numVertices);
+    double speedup = ms[1] / ms[0];
+    int passed = diff <= LTC_BENCH_TOLERANCE && (!size->m_gated || speedup >= LTC_BENCH_TARGET);
+    printf("%5u x %-5u %-11s %9u %9.3f %10.3f %8.2fx %10.3f %7.2fx %10.2g  %s\n", size->m_divLongitude,
+           size->m_divLatitude, streamed ? "streams" : "interleaved", numVertices, ms[1], ms[0], speedup, floor,
+           ms[1] / floor, diff, !passed ? "FAILED" : size->m_gated ? "ok" : "info");
+
+    free(buffers[0]);
+    free(buffers[1]);
+    return !passed;
+}
+
+int main(void)
+{
+    /* output of about 128 KB, 2 MB, 32 MB and 500 MB */
+    static const LtcBenchSize sizes[] =
+    {
+        { 64, 32, 1, 500 },
+        { 256, 128, 1, 100 },
+        { 1024, 512, 0, 15 },
+        { 4096, 2048, 0, 5 },
+    };
+
+    int failed = 0;
+    printf("%-13s %-11s %9s %9s %10s %9s %10s %8s %10s\n", "divisions", "output", "vertices", "naive ms",
+           "lattica ms", "speedup", "floor ms", "bound", "max diff");
+    for(uint32_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+    {
+        for(int streamed = 0; streamed < 2; ++streamed)
+            failed |= ltcBenchRun(&sizes[s], streamed);
+    }
+    printf("%s (target %.1fx on the gated sizes)\n", failed ? "FAILED" : "passed", LTC_BENCH_TARGET);
+    return failed;
+}
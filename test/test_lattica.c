@@ -0,0 +1,869 @@
+#include <lattica/cache.h>
+#include <lattica/stream.h>
+#include <lattica/threadpool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Behaviour tests for the features layered on ltcGenerateGeometry: streaming,
+ * the geometry cache and its index templates, submeshes, strips and the
+ * thread pool. Each one is checked against a single threaded
+ * ltcGenerateGeometry of the same config with 32 bit indices, and against the
+ * counts the headers document. Returns non-zero when any check fails. */
+
+#define LTC_TEST_CHECK(condition) ltcTestCheck((condition) != 0, #condition, __LINE__)
+
+static int s_numFailures = 0;
+
+static void ltcTestCheck(int passed, const char *condition, int line)
+{
+    if(passed)
+        return;
+    printf("%s:%d: check failed: %s\n", __FILE__, line, condition);
+    ++s_numFailures;
+}
+
+/* float positions, normals and texture coordinates whose payloads lattica
+ * allocates */
+static const LtcVertexAttribBuffer s_attribs[] =
+{
+    { NULL, 0, LTC_VERTEX_ATTRIB_TYPE_POSITION, LTC_VERTEX_ATTRIB_SIZE_FLOAT3, 0, LTC_VERTEX_ATTRIB_FORMAT_FLOAT },
+    { NULL, 0, LTC_VERTEX_ATTRIB_TYPE_NORMAL, LTC_VERTEX_ATTRIB_SIZE_FLOAT3, 0, LTC_VERTEX_ATTRIB_FORMAT_FLOAT },
+    { NULL, 0, LTC_VERTEX_ATTRIB_TYPE_TEXCOORD, LTC_VERTEX_ATTRIB_SIZE_FLOAT2, 0, LTC_VERTEX_ATTRIB_FORMAT_FLOAT },
+};
+
+#define LTC_TEST_NUM_ATTRIBS (sizeof(s_attribs) / sizeof(s_attribs[0]))
+
+/* Attaches s_attribs and, unless indexSize is LTC_INDEX_SIZE_NONE, indices. */
+static void ltcTestInitGeometry(LtcGeometry *geometry, LtcIndexBuffer *indices, LtcIndexSize_t indexSize)
+{
+    memset(geometry, 0, sizeof(*geometry));
+    for(uint32_t a = 0; a < LTC_TEST_NUM_ATTRIBS; ++a)
+        ltcAddVertexAttribBuffer(geometry, &s_attribs[a]);
+    if(indexSize == LTC_INDEX_SIZE_NONE)
+        return;
+    indices->m_buffer    = NULL;
+    indices->m_indexSize = indexSize;
+    ltcSetIndexBuffer(geometry, indices);
+}
+
+/* The reference: config generated on the calling thread with 32 bit indices. */
+static void ltcTestGenerateReference(LtcConfig *config, LtcGeometry *geometry, LtcIndexBuffer *indices)
+{
+    const LtcTaskInterface *taskInterface = config->m_taskInterface;
+    config->m_taskInterface = NULL;
+    ltcTestInitGeometry(geometry, indices, LTC_INDEX_SIZE_32);
+    LTC_TEST_CHECK(ltcGenerateGeometry(config, geometry) == LTC_OK);
+    config->m_taskInterface = taskInterface;
+}
+
+static uint32_t ltcTestIndex(const LtcGeometry *geometry, uint32_t i)
+{
+    const void *buffer = geometry->m_indices->m_buffer;
+    switch(geometry->m_indexSize)
+    {
+    case LTC_INDEX_SIZE_8:
+        return ((const uint8_t *)buffer)[i];
+    case LTC_INDEX_SIZE_16:
+        return ((const uint16_t *)buffer)[i];
+    default:
+        return ((const uint32_t *)buffer)[i];
+    }
+}
+
+/* Whether vertex va of a and vertex vb of b hold the same bytes in every
+ * attribute of s_attribs. */
+static int ltcTestSameVertex(const LtcGeometry *a, uint32_t va, const LtcGeometry *b, uint32_t vb)
+{
+    for(uint32_t slot = 0; slot < LTC_VERTEX_ATTRIB_COUNT; ++slot)
+    {
+        if(!(a->m_vertexAttribMask & (1u << slot)))
+            continue;
+        const LtcVertexAttribBuffer *attribA = &a->m_vertexAttribs[slot];
+        const LtcVertexAttribBuffer *attribB = &b->m_vertexAttribs[slot];
+        size_t size = ltcGetVertexAttribBufferSize(attribA, 1);
+        size_t strideA = attribA->m_stride ? attribA->m_stride : size;
+        size_t strideB = attribB->m_stride ? attribB->m_stride : size;
+        if(memcmp((const uint8_t *)attribA->m_buffer + va * strideA, (const uint8_t *)attribB->m_buffer + vb * strideB,
+                  size))
+            return 0;
+    }
+    return 1;
+}
+
+/* Whether a and b are identical, index size included. */
+static int ltcTestSameGeometry(const LtcGeometry *a, const LtcGeometry *b)
+{
+    if(a->m_numVertices != b->m_numVertices || a->m_numIndices != b->m_numIndices || a->m_indexSize != b->m_indexSize)
+        return 0;
+    for(uint32_t v = 0; v < a->m_numVertices; ++v)
+    {
+        if(!ltcTestSameVertex(a, v, b, v))
+            return 0;
+    }
+    return !a->m_numIndices ||
+           !memcmp(a->m_indices->m_buffer, b->m_indices->m_buffer, ltcGetIndexBufferSize(a->m_indexSize, a->m_numIndices));
+}
+
+/* Whether index i of geometry refers to the same vertex, or is the same
+ * restart, as index ri of reference, given geometry's indices are relative
+ * to baseVertex. */
+static int ltcTestSameIndex(const LtcGeometry *geometry, uint32_t i, uint32_t baseVertex, const LtcGeometry *reference,
+                            uint32_t ri)
+{
+    uint32_t index = ltcTestIndex(geometry, i);
+    uint32_t referenceIndex = ltcTestIndex(reference, ri);
+    if(referenceIndex == ltcGetPrimitiveRestartIndex(reference->m_indexSize))
+        return index == ltcGetPrimitiveRestartIndex(geometry->m_indexSize);
+    return baseVertex + index < geometry->m_numVertices &&
+           ltcTestSameVertex(geometry, baseVertex + index, reference, referenceIndex);
+}
+
+/* Streaming ----------------------------------------------------------------*/
+
+typedef struct
+{
+    const LtcGeometry *m_reference;
+    uint32_t           m_flags;
+    uint32_t           m_maxChunkVertices;
+    /* where the next chunk has to start */
+    LtcStreamChunk     m_next;
+    /* returns LTC_ERR_INTERNAL from this chunk on when non-zero */
+    uint64_t           m_stopAt;
+    uint32_t           m_numMismatches;
+} LtcTestStream;
+
+static LtcError_t ltcTestStreamChunk(const LtcStreamChunk *chunk, const LtcGeometry *geometry, void *userData)
+{
+    LtcTestStream *stream = (LtcTestStream *)userData;
+    if(stream->m_stopAt && chunk->m_chunk == stream->m_stopAt)
+        return LTC_ERR_INTERNAL;
+
+    const LtcGeometry *reference = stream->m_reference;
+    LTC_TEST_CHECK(chunk->m_chunk == stream->m_next.m_chunk);
+    LTC_TEST_CHECK(chunk->m_firstVertex == stream->m_next.m_firstVertex);
+    LTC_TEST_CHECK(chunk->m_firstIndex == stream->m_next.m_firstIndex);
+    LTC_TEST_CHECK(chunk->m_numVertices == geometry->m_numVertices && chunk->m_numIndices == geometry->m_numIndices);
+    LTC_TEST_CHECK(chunk->m_numVertices <= stream->m_maxChunkVertices);
+
+    int global = (stream->m_flags & LTC_STREAM_FLAG_GLOBAL_INDICES) != 0;
+    for(uint32_t v = 0; global && v < chunk->m_numVertices; ++v)
+        stream->m_numMismatches += !ltcTestSameVertex(geometry, v, reference, (uint32_t)chunk->m_firstVertex + v);
+    for(uint32_t i = 0; i < chunk->m_numIndices; ++i)
+    {
+        uint32_t ri = (uint32_t)chunk->m_firstIndex + i;
+        if(global)
+        {
+            /* global indices continue across cuts, so they equal the
+             * reference except for the restart value */
+            uint32_t index = ltcTestIndex(geometry, i);
+            uint32_t referenceIndex = ltcTestIndex(reference, ri);
+            if(referenceIndex == ltcGetPrimitiveRestartIndex(reference->m_indexSize))
+                stream->m_numMismatches += index != ltcGetPrimitiveRestartIndex(geometry->m_indexSize);
+            else
+                stream->m_numMismatches += index != referenceIndex;
+        }
+        else
+            stream->m_numMismatches += !ltcTestSameIndex(geometry, i, 0, reference, ri);
+    }
+
+    ++stream->m_next.m_chunk;
+    stream->m_next.m_firstVertex += chunk->m_numVertices;
+    stream->m_next.m_firstIndex  += chunk->m_numIndices;
+    return LTC_OK;
+}
+
+/* rowSize is the vertex count of one grid row for single patch shapes whose
+ * repeated cut rows can be counted, 0 otherwise. */
+static void ltcTestStream(LtcConfig *config, uint32_t maxChunkVertices, uint32_t rowSize)
+{
+    LtcGeometry reference;
+    LtcIndexBuffer referenceIndices;
+    ltcTestGenerateReference(config, &reference, &referenceIndices);
+
+    for(uint32_t flags = 0; flags <= LTC_STREAM_FLAG_GLOBAL_INDICES; ++flags)
+    {
+        LtcStreamSize size;
+        LTC_TEST_CHECK(ltcQueryGeometryStream(config, maxChunkVertices, flags, &size) == LTC_OK);
+        LTC_TEST_CHECK(size.m_numChunks > 1);
+        LTC_TEST_CHECK(size.m_maxChunkSize.m_numVertices <= maxChunkVertices);
+        LTC_TEST_CHECK(size.m_numIndices == reference.m_numIndices);
+        if(flags & LTC_STREAM_FLAG_GLOBAL_INDICES)
+            LTC_TEST_CHECK(size.m_numVertices == reference.m_numVertices);
+        else if(rowSize)
+            LTC_TEST_CHECK(size.m_numVertices == reference.m_numVertices + (size.m_numChunks - 1) * rowSize);
+
+        LtcTestStream stream;
+        memset(&stream, 0, sizeof(stream));
+        stream.m_reference        = &reference;
+        stream.m_flags            = flags;
+        stream.m_maxChunkVertices = maxChunkVertices;
+
+        LtcGeometry chunkGeometry;
+        LtcIndexBuffer chunkIndices;
+        ltcTestInitGeometry(&chunkGeometry, &chunkIndices, LTC_INDEX_SIZE_AUTO);
+        LTC_TEST_CHECK(ltcGenerateGeometryStream(config, maxChunkVertices, flags, &chunkGeometry, ltcTestStreamChunk,
+                                                 &stream) == LTC_OK);
+        LTC_TEST_CHECK(stream.m_numMismatches == 0);
+        LTC_TEST_CHECK(stream.m_next.m_chunk == size.m_numChunks);
+        LTC_TEST_CHECK(stream.m_next.m_firstVertex == size.m_numVertices);
+        LTC_TEST_CHECK(stream.m_next.m_firstIndex == size.m_numIndices);
+
+        /* a callback error stops the stream and is returned */
+        memset(&stream.m_next, 0, sizeof(stream.m_next));
+        stream.m_stopAt = 1;
+        LTC_TEST_CHECK(ltcGenerateGeometryStream(config, maxChunkVertices, flags, &chunkGeometry, ltcTestStreamChunk,
+                                                 &stream) == LTC_ERR_INTERNAL);
+        LTC_TEST_CHECK(stream.m_next.m_chunk == 1);
+        ltcFreeGeometry(&chunkGeometry);
+    }
+    ltcFreeGeometry(&reference);
+}
+
+static void ltcTestStreams(const LtcTaskInterface *taskInterface)
+{
+    LtcConfigPlane plane;
+    ltcInitDefaultConfigPlane(&plane);
+    plane.m_divX = 37;
+    plane.m_divY = 53;
+    ltcTestStream(&plane.m_common, 200, plane.m_divX + 1u);
+    plane.m_common.m_indexTopology = LTC_INDEX_TOPOLOGY_TRIANGLE_STRIP;
+    ltcTestStream(&plane.m_common, 200, plane.m_divX + 1u);
+
+    LtcConfigSphere sphere;
+    ltcInitDefaultConfigSphere(&sphere);
+    sphere.m_divLongitude = 300;
+    sphere.m_divLatitude  = 200;
+    sphere.m_common.m_taskInterface = taskInterface;
+    ltcTestStream(&sphere.m_common, 20000, 0);
+
+    LtcConfigCuboid cuboid;
+    ltcInitDefaultConfigCuboid(&cuboid);
+    cuboid.m_divX = cuboid.m_divY = cuboid.m_divZ = 20;
+    cuboid.m_common.m_windingOrder = LTC_WINDING_ORDER_CLOCKWISE;
+    ltcTestStream(&cuboid.m_common, 300, 0);
+
+    /* two vertex rows have to fit */
+    LtcStreamSize size;
+    LTC_TEST_CHECK(ltcQueryGeometryStream(&plane.m_common, 2 * 38 - 1, LTC_STREAM_FLAG_NONE, &size) ==
+                   LTC_ERR_INVALIDARGS);
+}
+
+/* Cache --------------------------------------------------------------------*/
+
+static void ltcTestCacheStats(const LtcGeometryCache *cache, uint64_t hits, uint64_t misses, uint64_t evictions,
+                              uint32_t numEntries)
+{
+    LtcGeometryCacheStats stats;
+    ltcGeometryCacheGetStats(cache, &stats);
+    LTC_TEST_CHECK(stats.m_hits == hits);
+    LTC_TEST_CHECK(stats.m_misses == misses);
+    LTC_TEST_CHECK(stats.m_evictions == evictions);
+    LTC_TEST_CHECK(stats.m_numEntries == numEntries);
+}
+
+static void ltcTestCache(void)
+{
+    LtcGeometryCache *cache;
+    LTC_TEST_CHECK(ltcGeometryCacheCreate(NULL, (size_t)1 << 24, &cache) == LTC_OK);
+
+    /* equal configs hit whatever their padding or attribute order */
+    LtcConfigSphere sphere, equal;
+    ltcInitDefaultConfigSphere(&sphere);
+    memset(&equal, 0xCD, sizeof(equal));
+    ltcInitDefaultConfigSphere(&equal);
+    LtcVertexAttribBuffer reversed[LTC_TEST_NUM_ATTRIBS];
+    for(uint32_t a = 0; a < LTC_TEST_NUM_ATTRIBS; ++a)
+        reversed[a] = s_attribs[LTC_TEST_NUM_ATTRIBS - 1 - a];
+
+    const LtcGeometry *first, *second, *other;
+    LTC_TEST_CHECK(ltcGeometryCacheAcquire(cache, &sphere.m_common, s_attribs, LTC_TEST_NUM_ATTRIBS,
+                                           LTC_INDEX_SIZE_32, &first) == LTC_OK);
+    ltcTestCacheStats(cache, 0, 1, 0, 1);
+    LTC_TEST_CHECK(ltcGeometryCacheAcquire(cache, &equal.m_common, reversed, LTC_TEST_NUM_ATTRIBS, LTC_INDEX_SIZE_32,
+                                           &second) == LTC_OK);
+    LTC_TEST_CHECK(first == second);
+    ltcTestCacheStats(cache, 1, 1, 0, 1);
+
+    LtcGeometryCacheStats stats;
+    ltcGeometryCacheGetStats(cache, &stats);
+    LTC_TEST_CHECK(stats.m_numSharedBytes > 0);
+
+    LtcGeometry reference;
+    LtcIndexBuffer referenceIndices;
+    ltcTestGenerateReference(&sphere.m_common, &reference, &referenceIndices);
+    LTC_TEST_CHECK(ltcTestSameGeometry(first, &reference));
+    ltcFreeGeometry(&reference);
+
+    /* the index size and the dimensions are part of the key */
+    LTC_TEST_CHECK(ltcGeometryCacheAcquire(cache, &sphere.m_common, s_attribs, LTC_TEST_NUM_ATTRIBS,
+                                           LTC_INDEX_SIZE_16, &other) == LTC_OK);
+    LTC_TEST_CHECK(other != first);
+    ltcGeometryCacheRelease(cache, other);
+    equal.m_radius = 2.0f;
+    LTC_TEST_CHECK(ltcGeometryCacheAcquire(cache, &equal.m_common, s_attribs, LTC_TEST_NUM_ATTRIBS,
+                                           LTC_INDEX_SIZE_32, &other) == LTC_OK);
+    LTC_TEST_CHECK(other != first);
+    ltcGeometryCacheRelease(cache, other);
+    ltcTestCacheStats(cache, 1, 3, 0, 3);
+
+    /* entries outlive their last release while they fit the budget */
+    ltcGeometryCacheRelease(cache, second);
+    ltcGeometryCacheGetStats(cache, &stats);
+    LTC_TEST_CHECK(stats.m_numSharedBytes == 0);
+    ltcGeometryCacheRelease(cache, first);
+    ltcTestCacheStats(cache, 1, 3, 0, 3);
+    ltcGeometryCacheTrim(cache);
+    ltcGeometryCacheGetStats(cache, &stats);
+    LTC_TEST_CHECK(stats.m_numEntries == 0 && stats.m_numBytes == 0);
+    ltcGeometryCacheDestroy(cache);
+
+    /* a budget of two equally sized entries evicts the least recently used
+     * unreferenced one, and never a referenced one */
+    LtcConfigCuboid cuboids[3];
+    for(uint32_t c = 0; c < 3; ++c)
+    {
+        ltcInitDefaultConfigCuboid(&cuboids[c]);
+        cuboids[c].m_sizeX = 1.0f + (float)c;
+    }
+    LTC_TEST_CHECK(ltcGeometryCacheCreate(NULL, 0, &cache) == LTC_OK);
+    LTC_TEST_CHECK(ltcGeometryCacheAcquire(cache, &cuboids[0].m_common, s_attribs, LTC_TEST_NUM_ATTRIBS,
+                                           LTC_INDEX_SIZE_16, &first) == LTC_OK);
+    ltcGeometryCacheGetStats(cache, &stats);
+    size_t entryBytes = stats.m_numBytes;
+    ltcGeometryCacheRelease(cache, first);
+    ltcTestCacheStats(cache, 0, 1, 1, 0);
+    ltcGeometryCacheDestroy(cache);
+
+    LTC_TEST_CHECK(ltcGeometryCacheCreate(NULL, 2 * entryBytes, &cache) == LTC_OK);
+    const LtcGeometry *held;
+    LTC_TEST_CHECK(ltcGeometryCacheAcquire(cache, &cuboids[0].m_common, s_attribs, LTC_TEST_NUM_ATTRIBS,
+                                           LTC_INDEX_SIZE_16, &held) == LTC_OK);
+    for(uint32_t c = 0; c < 3; ++c)
+    {
+        LTC_TEST_CHECK(ltcGeometryCacheAcquire(cache, &cuboids[c].m_common, s_attribs, LTC_TEST_NUM_ATTRIBS,
+                                               LTC_INDEX_SIZE_16, &other) == LTC_OK);
+        ltcGeometryCacheRelease(cache, other);
+    }
+    /* cuboids[0] is still held, so cuboids[1] went once cuboids[2] came */
+    ltcTestCacheStats(cache, 1, 3, 1, 2);
+    LTC_TEST_CHECK(ltcGeometryCacheAcquire(cache, &cuboids[2].m_common, s_attribs, LTC_TEST_NUM_ATTRIBS,
+                                           LTC_INDEX_SIZE_16, &other) == LTC_OK);
+    ltcGeometryCacheRelease(cache, other);
+    ltcTestCacheStats(cache, 2, 3, 1, 2);
+
+    ltcTestGenerateReference(&cuboids[0].m_common, &reference, &referenceIndices);
+    LTC_TEST_CHECK(held->m_indexSize == LTC_INDEX_SIZE_16 && held->m_numIndices == reference.m_numIndices);
+    for(uint32_t i = 0; i < reference.m_numIndices; ++i)
+        LTC_TEST_CHECK(ltcTestIndex(held, i) == ltcTestIndex(&reference, i));
+    ltcFreeGeometry(&reference);
+
+    ltcGeometryCacheRelease(cache, held);
+    ltcTestCacheStats(cache, 2, 3, 1, 2);
+    ltcGeometryCacheDestroy(cache);
+}
+
+static void ltcTestIndexTemplates(void)
+{
+    LtcGeometryCache *cache;
+    LTC_TEST_CHECK(ltcGeometryCacheCreate(NULL, (size_t)1 << 24, &cache) == LTC_OK);
+
+    /* a plane and a torus of the same grid share one template */
+    LtcConfigPlane plane;
+    ltcInitDefaultConfigPlane(&plane);
+    plane.m_divX = 8;
+    plane.m_divY = 6;
+    LtcConfigTorus torus;
+    ltcInitDefaultConfigTorus(&torus);
+    torus.m_divRadialMajor = 8;
+    torus.m_divRadialMinor = 6;
+
+    const LtcGeometry *planeTemplate, *torusTemplate;
+    LTC_TEST_CHECK(ltcGeometryCacheAcquireIndices(cache, &plane.m_common, LTC_INDEX_SIZE_AUTO, &planeTemplate) ==
+                   LTC_OK);
+    LTC_TEST_CHECK(ltcGeometryCacheAcquireIndices(cache, &torus.m_common, LTC_INDEX_SIZE_AUTO, &torusTemplate) ==
+                   LTC_OK);
+    LTC_TEST_CHECK(planeTemplate == torusTemplate);
+    LTC_TEST_CHECK(planeTemplate->m_vertexAttribMask == 0);
+    LTC_TEST_CHECK(planeTemplate->m_numVertices == 9u * 7u);
+    LTC_TEST_CHECK(planeTemplate->m_indexSize == LTC_INDEX_SIZE_8);
+
+    LtcGeometry reference;
+    LtcIndexBuffer referenceIndices;
+    ltcTestGenerateReference(&torus.m_common, &reference, &referenceIndices);
+    LTC_TEST_CHECK(planeTemplate->m_numIndices == reference.m_numIndices);
+    for(uint32_t i = 0; i < reference.m_numIndices; ++i)
+        LTC_TEST_CHECK(ltcTestIndex(planeTemplate, i) == ltcTestIndex(&reference, i));
+    ltcFreeGeometry(&reference);
+
+    /* cylinders differing in dimensions only share one template; vertices
+     * generated without indices draw with it as the full generation does */
+    enum { LTC_TEST_NUM_CYLINDERS = 16 };
+    const LtcGeometry *cylinderTemplates[LTC_TEST_NUM_CYLINDERS];
+    LtcConfigCylinder cylinder;
+    ltcInitDefaultConfigCylinder(&cylinder);
+    cylinder.m_common.m_flags = LTC_CONFIG_FLAG_OPTIMIZE_VERTEX_CACHE;
+    for(uint32_t c = 0; c < LTC_TEST_NUM_CYLINDERS; ++c)
+    {
+        cylinder.m_radius = 0.5f + 0.1f * (float)c;
+        LTC_TEST_CHECK(ltcGeometryCacheAcquireIndices(cache, &cylinder.m_common, LTC_INDEX_SIZE_16,
+                                                      &cylinderTemplates[c]) == LTC_OK);
+        LTC_TEST_CHECK(cylinderTemplates[c] == cylinderTemplates[0]);
+    }
+
+    LtcGeometryCacheStats stats;
+    ltcGeometryCacheGetStats(cache, &stats);
+    LTC_TEST_CHECK(stats.m_numEntries == 2);
+    LTC_TEST_CHECK(stats.m_numSharedBytes > 0);
+
+    LtcGeometry vertices;
+    ltcTestInitGeometry(&vertices, NULL, LTC_INDEX_SIZE_NONE);
+    LTC_TEST_CHECK(ltcGenerateGeometry(&cylinder.m_common, &vertices) == LTC_OK);
+    ltcTestGenerateReference(&cylinder.m_common, &reference, &referenceIndices);
+    LTC_TEST_CHECK(vertices.m_numVertices == cylinderTemplates[0]->m_numVertices);
+    LTC_TEST_CHECK(cylinderTemplates[0]->m_numIndices == reference.m_numIndices);
+    for(uint32_t i = 0; i < reference.m_numIndices; ++i)
+        LTC_TEST_CHECK(ltcTestSameVertex(&vertices, ltcTestIndex(cylinderTemplates[0], i), &reference,
+                                         ltcTestIndex(&reference, i)));
+    ltcFreeGeometry(&vertices);
+    ltcFreeGeometry(&reference);
+
+    /* winding is part of the template; vertex fetch order and no indices are
+     * rejected */
+    const LtcGeometry *other;
+    cylinder.m_common.m_windingOrder = LTC_WINDING_ORDER_CLOCKWISE;
+    LTC_TEST_CHECK(ltcGeometryCacheAcquireIndices(cache, &cylinder.m_common, LTC_INDEX_SIZE_16, &other) == LTC_OK);
+    LTC_TEST_CHECK(other != cylinderTemplates[0]);
+    ltcGeometryCacheRelease(cache, other);
+    cylinder.m_common.m_flags |= LTC_CONFIG_FLAG_OPTIMIZE_VERTEX_FETCH;
+    LTC_TEST_CHECK(ltcGeometryCacheAcquireIndices(cache, &cylinder.m_common, LTC_INDEX_SIZE_16, &other) ==
+                   LTC_ERR_INVALIDARGS);
+    LTC_TEST_CHECK(ltcGeometryCacheAcquireIndices(cache, &plane.m_common, LTC_INDEX_SIZE_NONE, &other) ==
+                   LTC_ERR_INVALIDARGS);
+
+    for(uint32_t c = 0; c < LTC_TEST_NUM_CYLINDERS; ++c)
+        ltcGeometryCacheRelease(cache, cylinderTemplates[c]);
+    ltcGeometryCacheRelease(cache, planeTemplate);
+    ltcGeometryCacheRelease(cache, torusTemplate);
+    ltcGeometryCacheGetStats(cache, &stats);
+    LTC_TEST_CHECK(stats.m_numSharedBytes == 0);
+    ltcGeometryCacheDestroy(cache);
+}
+
+/* Submeshes ----------------------------------------------------------------*/
+
+/* rowSize as for ltcTestStream. */
+static void ltcTestSubmesh(LtcConfig *config, LtcIndexSize_t indexSize, LtcIndexSize_t expectedIndexSize,
+                           uint32_t expectedNumSubmeshes, uint32_t rowSize)
+{
+    LtcGeometry reference;
+    LtcIndexBuffer referenceIndices;
+    ltcTestGenerateReference(config, &reference, &referenceIndices);
+
+    uint32_t numSubmeshes;
+    LtcGeometrySize size;
+    LTC_TEST_CHECK(ltcQueryGeometrySubmeshes(config, indexSize, &numSubmeshes, &size) == LTC_OK);
+    LTC_TEST_CHECK(numSubmeshes == expectedNumSubmeshes);
+    LTC_TEST_CHECK(size.m_numIndices == reference.m_numIndices);
+    if(rowSize)
+        LTC_TEST_CHECK(size.m_numVertices == reference.m_numVertices + (numSubmeshes - 1) * rowSize);
+
+    LtcSubmesh *submeshes = (LtcSubmesh *)malloc(numSubmeshes * sizeof(LtcSubmesh));
+    LtcGeometry geometry;
+    LtcIndexBuffer indices;
+    ltcTestInitGeometry(&geometry, &indices, indexSize);
+    LTC_TEST_CHECK(ltcGenerateGeometrySubmeshes(config, submeshes, &geometry) == LTC_OK);
+    LTC_TEST_CHECK(geometry.m_indexSize == expectedIndexSize);
+    LTC_TEST_CHECK(geometry.m_numVertices == size.m_numVertices && geometry.m_numIndices == size.m_numIndices);
+
+    uint32_t maxVertices = ltcGetPrimitiveRestartIndex(expectedIndexSize);
+    if(config->m_indexTopology == LTC_INDEX_TOPOLOGY_TRIANGLE_LIST)
+        ++maxVertices;
+    uint32_t numMismatches = 0;
+    uint32_t nextVertex = 0, nextIndex = 0;
+    for(uint32_t s = 0; s < numSubmeshes; ++s)
+    {
+        const LtcSubmesh *submesh = &submeshes[s];
+        LTC_TEST_CHECK(submesh->m_baseVertex == nextVertex && submesh->m_firstIndex == nextIndex);
+        LTC_TEST_CHECK(submesh->m_numVertices <= maxVertices);
+        for(uint32_t i = submesh->m_firstIndex; i < submesh->m_firstIndex + submesh->m_numIndices; ++i)
+        {
+            uint32_t index = ltcTestIndex(&geometry, i);
+            numMismatches += index != ltcGetPrimitiveRestartIndex(geometry.m_indexSize) &&
+                             index >= submesh->m_numVertices;
+            numMismatches += !ltcTestSameIndex(&geometry, i, submesh->m_baseVertex, &reference, i);
+        }
+        /* the row on a cut opens the next submesh again */
+        if(rowSize && s > 0)
+        {
+            for(uint32_t v = 0; v < rowSize; ++v)
+                numMismatches += !ltcTestSameVertex(&geometry, submesh->m_baseVertex - rowSize + v, &geometry,
+                                                    submesh->m_baseVertex + v);
+        }
+        nextVertex += submesh->m_numVertices;
+        nextIndex  += submesh->m_numIndices;
+    }
+    LTC_TEST_CHECK(numMismatches == 0);
+    LTC_TEST_CHECK(nextVertex == geometry.m_numVertices && nextIndex == geometry.m_numIndices);
+
+    free(submeshes);
+    ltcFreeGeometry(&geometry);
+    ltcFreeGeometry(&reference);
+}
+
+static void ltcTestSubmeshes(void)
+{
+    /* 16 x 16 = 256 vertices: whole in 8 bit, unless a strip needs 255 to
+     * restart */
+    LtcConfigPlane plane;
+    ltcInitDefaultConfigPlane(&plane);
+    plane.m_divX = 15;
+    plane.m_divY = 15;
+    ltcTestSubmesh(&plane.m_common, LTC_INDEX_SIZE_AUTO, LTC_INDEX_SIZE_8, 1, 16);
+    plane.m_common.m_indexTopology = LTC_INDEX_TOPOLOGY_TRIANGLE_STRIP;
+    ltcTestSubmesh(&plane.m_common, LTC_INDEX_SIZE_AUTO, LTC_INDEX_SIZE_16, 1, 16);
+
+    /* 301 x 301 vertices: AUTO splits at 16 bit, after 65536 / 301 = 217 rows,
+     * so 300 quad rows take 216 + 84 */
+    plane.m_common.m_indexTopology = LTC_INDEX_TOPOLOGY_TRIANGLE_LIST;
+    plane.m_divX = plane.m_divY = 300;
+    ltcTestSubmesh(&plane.m_common, LTC_INDEX_SIZE_AUTO, LTC_INDEX_SIZE_16, 2, 301);
+
+    /* 21 x 51 vertices as 8 bit strips: 255 / 21 = 12 rows take 11 quad rows
+     * per submesh */
+    plane.m_common.m_indexTopology = LTC_INDEX_TOPOLOGY_TRIANGLE_STRIP;
+    plane.m_divX = 20;
+    plane.m_divY = 50;
+    ltcTestSubmesh(&plane.m_common, LTC_INDEX_SIZE_8, LTC_INDEX_SIZE_8, 5, 21);
+
+    LtcConfigSphere sphere;
+    ltcInitDefaultConfigSphere(&sphere);
+    sphere.m_divLongitude = 500;
+    sphere.m_divLatitude  = 400;
+    uint32_t numSubmeshes;
+    LtcGeometrySize size;
+    LTC_TEST_CHECK(ltcQueryGeometrySubmeshes(&sphere.m_common, LTC_INDEX_SIZE_16, &numSubmeshes, &size) == LTC_OK);
+    ltcTestSubmesh(&sphere.m_common, LTC_INDEX_SIZE_16, LTC_INDEX_SIZE_16, numSubmeshes, 0);
+    LTC_TEST_CHECK(numSubmeshes > 1);
+
+    LtcConfigCuboid cuboid;
+    ltcInitDefaultConfigCuboid(&cuboid);
+    cuboid.m_divX = cuboid.m_divY = cuboid.m_divZ = 20;
+    cuboid.m_common.m_windingOrder = LTC_WINDING_ORDER_CLOCKWISE;
+    LTC_TEST_CHECK(ltcQueryGeometrySubmeshes(&cuboid.m_common, LTC_INDEX_SIZE_8, &numSubmeshes, &size) == LTC_OK);
+    ltcTestSubmesh(&cuboid.m_common, LTC_INDEX_SIZE_8, LTC_INDEX_SIZE_8, numSubmeshes, 0);
+}
+
+/* Strips -------------------------------------------------------------------*/
+
+static int ltcTestCompareTriangles(const void *a, const void *b)
+{
+    return memcmp(a, b, 3 * sizeof(uint32_t));
+}
+
+/* Rotates the smallest index first, keeping the winding. */
+static void ltcTestCanonicalTriangle(uint32_t *triangle)
+{
+    while(triangle[0] > triangle[1] || triangle[0] > triangle[2])
+    {
+        uint32_t first = triangle[0];
+        triangle[0] = triangle[1];
+        triangle[1] = triangle[2];
+        triangle[2] = first;
+    }
+}
+
+/* Sorted canonical triangles of geometry, skipping the degenerate ones a strip
+ * has at its restarts; returns their number. */
+static uint32_t ltcTestTriangles(const LtcGeometry *geometry, LtcIndexTopology_t topology, uint32_t *triangles)
+{
+    uint32_t numTriangles = 0;
+    if(topology == LTC_INDEX_TOPOLOGY_TRIANGLE_LIST)
+    {
+        for(uint32_t i = 0; i + 2 < geometry->m_numIndices; i += 3, ++numTriangles)
+        {
+            for(uint32_t k = 0; k < 3; ++k)
+                triangles[3 * numTriangles + k] = ltcTestIndex(geometry, i + k);
+            ltcTestCanonicalTriangle(&triangles[3 * numTriangles]);
+        }
+    }
+    else
+    {
+        uint32_t restart = ltcGetPrimitiveRestartIndex(geometry->m_indexSize);
+        uint32_t length = 0;
+        for(uint32_t i = 0; i < geometry->m_numIndices; ++i)
+        {
+            if(ltcTestIndex(geometry, i) == restart)
+            {
+                length = 0;
+                continue;
+            }
+            if(++length < 3)
+                continue;
+            /* every other triangle of a strip has its first two indices
+             * swapped to keep the winding */
+            uint32_t *triangle = &triangles[3 * numTriangles];
+            triangle[0] = ltcTestIndex(geometry, length & 1 ? i - 2 : i - 1);
+            triangle[1] = ltcTestIndex(geometry, length & 1 ? i - 1 : i - 2);
+            triangle[2] = ltcTestIndex(geometry, i);
+            if(triangle[0] == triangle[1] || triangle[1] == triangle[2] || triangle[0] == triangle[2])
+                continue;
+            ltcTestCanonicalTriangle(triangle);
+            ++numTriangles;
+        }
+    }
+    qsort(triangles, numTriangles, 3 * sizeof(uint32_t), ltcTestCompareTriangles);
+    return numTriangles;
+}
+
+/* Checks the strips of config against its list: one strip per quad row, each
+ * ended by the restart index of the index size, covering the same triangles
+ * with the same winding. */
+static void ltcTestStrip(LtcConfig *config, LtcIndexSize_t indexSize, LtcIndexSize_t expectedIndexSize,
+                         uint32_t numQuadRows)
+{
+    LtcGeometry list, strip;
+    LtcIndexBuffer listIndices, stripIndices;
+    config->m_indexTopology = LTC_INDEX_TOPOLOGY_TRIANGLE_LIST;
+    ltcTestGenerateReference(config, &list, &listIndices);
+
+    config->m_indexTopology = LTC_INDEX_TOPOLOGY_TRIANGLE_STRIP;
+    LtcGeometrySize size;
+    LTC_TEST_CHECK(ltcQueryGeometrySize(config, &size) == LTC_OK);
+    ltcTestInitGeometry(&strip, &stripIndices, indexSize);
+    LTC_TEST_CHECK(ltcGenerateGeometry(config, &strip) == LTC_OK);
+    LTC_TEST_CHECK(strip.m_indexSize == expectedIndexSize);
+    LTC_TEST_CHECK(strip.m_numIndices == size.m_numIndices);
+    LTC_TEST_CHECK(strip.m_numVertices == list.m_numVertices);
+
+    uint32_t restart = ltcGetPrimitiveRestartIndex(strip.m_indexSize);
+    uint32_t numRestarts = 0;
+    for(uint32_t i = 0; i < strip.m_numIndices; ++i)
+    {
+        uint32_t index = ltcTestIndex(&strip, i);
+        numRestarts += index == restart;
+        LTC_TEST_CHECK(index == restart || index < strip.m_numVertices);
+    }
+    LTC_TEST_CHECK(numRestarts == numQuadRows);
+    LTC_TEST_CHECK(ltcTestIndex(&strip, strip.m_numIndices - 1) == restart);
+
+    uint32_t *listTriangles  = (uint32_t *)malloc((size_t)list.m_numIndices * sizeof(uint32_t));
+    uint32_t *stripTriangles = (uint32_t *)malloc((size_t)strip.m_numIndices * 3 * sizeof(uint32_t));
+    uint32_t numListTriangles  = ltcTestTriangles(&list, LTC_INDEX_TOPOLOGY_TRIANGLE_LIST, listTriangles);
+    uint32_t numStripTriangles = ltcTestTriangles(&strip, LTC_INDEX_TOPOLOGY_TRIANGLE_STRIP, stripTriangles);
+    LTC_TEST_CHECK(numListTriangles == numStripTriangles);
+    LTC_TEST_CHECK(numListTriangles == numStripTriangles &&
+                   !memcmp(listTriangles, stripTriangles, (size_t)numListTriangles * 3 * sizeof(uint32_t)));
+
+    free(listTriangles);
+    free(stripTriangles);
+    ltcFreeGeometry(&list);
+    ltcFreeGeometry(&strip);
+}
+
+static void ltcTestStrips(void)
+{
+    LTC_TEST_CHECK(ltcGetPrimitiveRestartIndex(LTC_INDEX_SIZE_8) == 0xFFu);
+    LTC_TEST_CHECK(ltcGetPrimitiveRestartIndex(LTC_INDEX_SIZE_16) == 0xFFFFu);
+    LTC_TEST_CHECK(ltcGetPrimitiveRestartIndex(LTC_INDEX_SIZE_32) == 0xFFFFFFFFu);
+    LTC_TEST_CHECK(ltcGetIndexSizeForVertices(256) == LTC_INDEX_SIZE_8);
+    LTC_TEST_CHECK(ltcGetIndexSizeForVertices(257) == LTC_INDEX_SIZE_16);
+    LTC_TEST_CHECK(ltcGetIndexSizeForVertices(65537) == LTC_INDEX_SIZE_32);
+
+    LtcConfigPlane plane;
+    ltcInitDefaultConfigPlane(&plane);
+    plane.m_divX = 100;
+    plane.m_divY = 37;
+    ltcTestStrip(&plane.m_common, LTC_INDEX_SIZE_16, LTC_INDEX_SIZE_16, 37);
+    ltcTestStrip(&plane.m_common, LTC_INDEX_SIZE_32, LTC_INDEX_SIZE_32, 37);
+    plane.m_common.m_windingOrder = LTC_WINDING_ORDER_CLOCKWISE;
+    ltcTestStrip(&plane.m_common, LTC_INDEX_SIZE_AUTO, LTC_INDEX_SIZE_16, 37);
+
+    /* 15 x 17 = 255 vertices leave 255 free to restart in 8 bit; 16 x 16 =
+     * 256 do not */
+    plane.m_divX = 14;
+    plane.m_divY = 16;
+    ltcTestStrip(&plane.m_common, LTC_INDEX_SIZE_AUTO, LTC_INDEX_SIZE_8, 16);
+    plane.m_divX = 15;
+    plane.m_divY = 15;
+    ltcTestStrip(&plane.m_common, LTC_INDEX_SIZE_AUTO, LTC_INDEX_SIZE_16, 15);
+
+    LtcGeometry geometry;
+    LtcIndexBuffer indices;
+    ltcTestInitGeometry(&geometry, &indices, LTC_INDEX_SIZE_8);
+    LTC_TEST_CHECK(ltcGenerateGeometry(&plane.m_common, &geometry) == LTC_ERR_INVALIDARGS);
+    ltcFreeGeometry(&geometry);
+
+    /* six faces of 20 quad rows each */
+    LtcConfigCuboid cuboid;
+    ltcInitDefaultConfigCuboid(&cuboid);
+    cuboid.m_divX = cuboid.m_divY = cuboid.m_divZ = 20;
+    ltcTestStrip(&cuboid.m_common, LTC_INDEX_SIZE_16, LTC_INDEX_SIZE_16, 6 * 20);
+}
+
+/* Thread pool --------------------------------------------------------------*/
+
+/* A task interface running the tasks of every enqueue backwards on the
+ * calling thread, the opposite of the order a single thread uses. */
+typedef struct
+{
+    LtcTaskFn m_fn;
+    void     *m_taskData;
+    uint32_t  m_numTasks;
+    uint32_t  m_maxTasks;
+} LtcTestReverseJob;
+
+static void *ltcTestReverseEnqueue(LtcTaskFn fn, void *taskData, uint32_t numTasks, void *userData)
+{
+    LtcTestReverseJob *job = (LtcTestReverseJob *)userData;
+    job->m_fn       = fn;
+    job->m_taskData = taskData;
+    job->m_numTasks = numTasks;
+    if(numTasks > job->m_maxTasks)
+        job->m_maxTasks = numTasks;
+    return job;
+}
+
+static void ltcTestReverseWait(void *handle, void *userData)
+{
+    (void)userData;
+    LtcTestReverseJob *job = (LtcTestReverseJob *)handle;
+    for(uint32_t t = job->m_numTasks; t-- > 0;)
+        job->m_fn(job->m_taskData, t);
+}
+
+static void ltcTestScheduled(LtcConfig *config, const LtcTaskInterface *taskInterface)
+{
+    LtcGeometry reference, geometry;
+    LtcIndexBuffer referenceIndices, indices;
+    ltcTestGenerateReference(config, &reference, &referenceIndices);
+
+    config->m_taskInterface = taskInterface;
+    ltcTestInitGeometry(&geometry, &indices, LTC_INDEX_SIZE_32);
+    LTC_TEST_CHECK(ltcGenerateGeometry(config, &geometry) == LTC_OK);
+    /* a second run reuses the allocated payloads */
+    LTC_TEST_CHECK(ltcGenerateGeometry(config, &geometry) == LTC_OK);
+    LTC_TEST_CHECK(ltcTestSameGeometry(&geometry, &reference));
+    config->m_taskInterface = NULL;
+
+    ltcFreeGeometry(&geometry);
+    ltcFreeGeometry(&reference);
+}
+
+static void ltcTestScheduledBatch(const LtcTaskInterface *taskInterface)
+{
+    enum { LTC_TEST_BATCH_SIZE = 60 };
+    LtcConfigSphere spheres[LTC_TEST_BATCH_SIZE];
+    LtcConfigTorus tori[LTC_TEST_BATCH_SIZE];
+    const LtcConfig *configs[2 * LTC_TEST_BATCH_SIZE];
+    for(uint32_t c = 0; c < LTC_TEST_BATCH_SIZE; ++c)
+    {
+        ltcInitDefaultConfigSphere(&spheres[c]);
+        spheres[c].m_divLongitude = (uint16_t)(8 + 7 * c);
+        ltcInitDefaultConfigTorus(&tori[c]);
+        tori[c].m_minorRadius = 0.05f + 0.001f * (float)c;
+        configs[2 * c]     = &tori[c].m_common;
+        configs[2 * c + 1] = &spheres[c].m_common;
+    }
+
+    for(uint32_t flags = 0; flags <= LTC_BATCH_FLAG_LOCAL_INDICES; ++flags)
+    {
+        LtcBatchItem serialItems[2 * LTC_TEST_BATCH_SIZE], items[2 * LTC_TEST_BATCH_SIZE];
+        LtcGeometry serial, geometry;
+        LtcIndexBuffer serialIndices, indices;
+        ltcTestInitGeometry(&serial, &serialIndices, LTC_INDEX_SIZE_32);
+        ltcTestInitGeometry(&geometry, &indices, LTC_INDEX_SIZE_32);
+        LTC_TEST_CHECK(ltcGenerateGeometryBatch(configs, 2 * LTC_TEST_BATCH_SIZE, flags, serialItems, &serial) ==
+                       LTC_OK);
+
+        /* every config has to use the same task interface */
+        tori[0].m_common.m_taskInterface = taskInterface;
+        LTC_TEST_CHECK(ltcGenerateGeometryBatch(configs, 2 * LTC_TEST_BATCH_SIZE, flags, items, &geometry) ==
+                       LTC_ERR_INVALIDARGS);
+        for(uint32_t c = 0; c < LTC_TEST_BATCH_SIZE; ++c)
+            spheres[c].m_common.m_taskInterface = tori[c].m_common.m_taskInterface = taskInterface;
+        LTC_TEST_CHECK(ltcGenerateGeometryBatch(configs, 2 * LTC_TEST_BATCH_SIZE, flags, items, &geometry) == LTC_OK);
+        LTC_TEST_CHECK(!memcmp(items, serialItems, sizeof(items)));
+        LTC_TEST_CHECK(ltcTestSameGeometry(&geometry, &serial));
+        for(uint32_t c = 0; c < LTC_TEST_BATCH_SIZE; ++c)
+            spheres[c].m_common.m_taskInterface = tori[c].m_common.m_taskInterface = NULL;
+
+        ltcFreeGeometry(&serial);
+        ltcFreeGeometry(&geometry);
+    }
+}
+
+static void ltcTestSchedules(const LtcTaskInterface *taskInterface)
+{
+    LtcConfigPlane plane;
+    ltcInitDefaultConfigPlane(&plane);
+    plane.m_divX = 301;
+    plane.m_divY = 257;
+    ltcTestScheduled(&plane.m_common, taskInterface);
+
+    LtcConfigSphere sphere;
+    ltcInitDefaultConfigSphere(&sphere);
+    sphere.m_divLongitude = 513;
+    sphere.m_divLatitude  = 255;
+    ltcTestScheduled(&sphere.m_common, taskInterface);
+    sphere.m_common.m_indexTopology = LTC_INDEX_TOPOLOGY_TRIANGLE_STRIP;
+    ltcTestScheduled(&sphere.m_common, taskInterface);
+
+    LtcConfigCapsule capsule;
+    ltcInitDefaultConfigCapsule(&capsule);
+    capsule.m_divRadial   = 300;
+    capsule.m_divLatitude = 100;
+    capsule.m_common.m_windingOrder = LTC_WINDING_ORDER_CLOCKWISE;
+    capsule.m_common.m_flags        = LTC_CONFIG_FLAG_OPTIMIZE_VERTEX_CACHE;
+    ltcTestScheduled(&capsule.m_common, taskInterface);
+
+    LtcConfigTorusKnot torusKnot;
+    ltcInitDefaultConfigTorusKnot(&torusKnot);
+    torusKnot.m_divRadial  = 64;
+    torusKnot.m_divTubular = 4096;
+    ltcTestScheduled(&torusKnot.m_common, taskInterface);
+
+    ltcTestScheduledBatch(taskInterface);
+}
+
+static void ltcTestThreadPools(void)
+{
+    /* the pool hands out tasks in a different order every run; output must
+     * not depend on that, nor on the number of workers */
+    static const uint32_t numThreads[] = { 2, 3, 8 };
+    for(uint32_t n = 0; n < sizeof(numThreads) / sizeof(numThreads[0]); ++n)
+    {
+        LtcThreadPool *pool;
+        LTC_TEST_CHECK(ltcThreadPoolCreate(NULL, numThreads[n], &pool) == LTC_OK);
+        LTC_TEST_CHECK(ltcThreadPoolGetNumThreads(pool) == numThreads[n]);
+        for(int run = 0; run < 3; ++run)
+            ltcTestSchedules(ltcThreadPoolGetTaskInterface(pool));
+        ltcThreadPoolDestroy(pool);
+    }
+
+    LtcTestReverseJob job;
+    memset(&job, 0, sizeof(job));
+    LtcTaskInterface reverse = { ltcTestReverseEnqueue, ltcTestReverseWait, 16, &job };
+    ltcTestSchedules(&reverse);
+    /* the meshes above are large enough to be split */
+    LTC_TEST_CHECK(job.m_maxTasks > 1);
+}
+
+int main(void)
+{
+    LtcThreadPool *pool;
+    if(ltcThreadPoolCreate(NULL, 4, &pool) != LTC_OK)
+        return 1;
+
+    ltcTestStreams(NULL);
+    ltcTestStreams(ltcThreadPoolGetTaskInterface(pool));
+    ltcTestCache();
+    ltcTestIndexTemplates();
+    ltcTestSubmeshes();
+    ltcTestStrips();
+    ltcTestThreadPools();
+
+    ltcThreadPoolDestroy(pool);
+    printf("%s (%d failed checks)\n", s_numFailures ? "FAILED" : "passed", s_numFailures);
+    return s_numFailures != 0;
+}